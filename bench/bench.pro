@@ -0,0 +1,53 @@
+# 搜索引擎基准测试工具(无界面): qmake bench/bench.pro && make
+QT = core
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+TARGET = bench
+
+INCLUDEPATH += ../src
+
+# 位棋盘走子后端(qmake "CONFIG+=bitboard"), 见src/bitboard.h
+bitboard: DEFINES += CCHESS_BITBOARD
+
+SOURCES += \
+    main.cpp \
+    ../src/board.cpp \
+    ../src/boardpieces.cpp \
+    ../src/boardseats.cpp \
+    ../src/engine.cpp \
+    ../src/evaluation.cpp \
+    ../src/fencodec.cpp \
+    ../src/moveorder.cpp \
+    ../src/perft.cpp \
+    ../src/piece.cpp \
+    ../src/piecebase.cpp \
+    ../src/position.cpp \
+    ../src/repetition.cpp \
+    ../src/searchthreads.cpp \
+    ../src/seat.cpp \
+    ../src/seatbase.cpp \
+    ../src/transpositiontable.cpp \
+    ../src/zhnotation.cpp
+
+HEADERS += \
+    ../src/bitboard.h \
+    ../src/board.h \
+    ../src/boardpieces.h \
+    ../src/boardseats.h \
+    ../src/engine.h \
+    ../src/evaluation.h \
+    ../src/fencodec.h \
+    ../src/movelist.h \
+    ../src/moveorder.h \
+    ../src/perft.h \
+    ../src/piece.h \
+    ../src/piecebase.h \
+    ../src/position.h \
+    ../src/repetition.h \
+    ../src/searchthreads.h \
+    ../src/seat.h \
+    ../src/seatbase.h \
+    ../src/seattable.h \
+    ../src/transpositiontable.h \
+    ../src/zhnotation.h
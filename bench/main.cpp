@@ -0,0 +1,173 @@
+#include "board.h"
+#include "fencodec.h"
+#include "perft.h"
+#include "piece.h"
+#include "searchthreads.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
+
+#include <vector>
+
+// 逐个局面搜索, 返回合计用时(毫秒); 输出每个局面的最佳着法、分值、主要变例及着法排序统计
+static qint64 runBench(QTextStream& out, const QStringList& fens, const SearchLimits& limits,
+    TranspositionTable& table, int threadCount, quint64& totalNodes)
+{
+    qint64 totalMsecs { 0 };
+    OrderStats totalStats;
+    totalNodes = 0;
+    for (auto& fen : fens) {
+        Board board {};
+        PieceColor color;
+        if (!Perft::setFEN(board, fen, color)) {
+            out << "FEN错误: " << fen << Qt::endl;
+            continue;
+        }
+
+        table.clear();
+        SearchThreads searchThreads(board.position(), &table, threadCount);
+        SearchResult result { searchThreads.search(limits) };
+        QStringList pvStrings;
+        for (PackedMove move : result.pv)
+            pvStrings.append(Perft::moveString(move));
+
+        out << fen << Qt::endl
+            << QString("  深度%1 分值%2 结点%3 %4 ms, 置换表占用%5‰, 主要变例: %6")
+                   .arg(result.depth)
+                   .arg(result.score)
+                   .arg(result.nodes)
+                   .arg(result.msecs)
+                   .arg(table.hashfull())
+                   .arg(pvStrings.join(' '))
+            << Qt::endl
+            << QString("  首着截断率%1%, 截断着法平均序号%2")
+                   .arg(result.orderStats.firstMoveCutRate(), 0, 'f', 1)
+                   .arg(result.orderStats.averageCutIndex(), 0, 'f', 2)
+            << Qt::endl;
+        totalStats.add(result.orderStats);
+        totalNodes += result.nodes;
+        totalMsecs += result.msecs;
+    }
+
+    out << QString("%1线程合计: %2 结点, %3 ms, %4 nps, 首着截断率%5%\n")
+               .arg(threadCount)
+               .arg(totalNodes)
+               .arg(totalMsecs)
+               .arg(totalNodes * 1000 / qMax(totalMsecs, qint64(1)))
+               .arg(totalStats.firstMoveCutRate(), 0, 'f', 1)
+        << Qt::endl;
+
+    return qMax(totalMsecs, qint64(1));
+}
+
+// FEN编解码吞吐量: 逐行读入文件(FEN或局面库的键, 解码遇空格或'_'即止), 分批解码后再编码,
+// 输出各类错误数及每秒局面数
+static void runFenBench(QTextStream& out, const QString& filename)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        out << "不能打开文件: " << filename << Qt::endl;
+        return;
+    }
+
+    std::vector<QString> fens;
+    QTextStream stream(&file);
+    while (!stream.atEnd())
+        fens.push_back(stream.readLine());
+
+    const int batchSize { 4096 };
+    std::vector<QChar> pieChars(batchSize * FenCodec::SEATNUM);
+    std::vector<FenCodec::Error> errors(batchSize);
+    QChar fen[FenCodec::MAXLENGTH];
+    int errorCounts[int(FenCodec::Error::BISHOPSEAT) + 1] {};
+    qint64 decodeNsecs { 0 }, encodeNsecs { 0 };
+    int validCount { 0 };
+    QElapsedTimer timer;
+    int fenCount { int(fens.size()) };
+    for (int first = 0; first < fenCount; first += batchSize) {
+        int count { qMin(batchSize, fenCount - first) };
+        timer.start();
+        validCount += FenCodec::decodeBatch(fens.data() + first, count, pieChars.data(), errors.data());
+        decodeNsecs += timer.nsecsElapsed();
+
+        timer.start();
+        for (int index = 0; index < count; ++index)
+            if (errors[index] == FenCodec::Error::NONE)
+                FenCodec::encode(pieChars.data() + index * FenCodec::SEATNUM, fen);
+        encodeNsecs += timer.nsecsElapsed();
+
+        for (int index = 0; index < count; ++index)
+            ++errorCounts[int(errors[index])];
+    }
+
+    out << QString("%1: %2 个局面, 合格%3个").arg(filename).arg(fenCount).arg(validCount) << Qt::endl;
+    for (int error = int(FenCodec::Error::ROWCOUNT); error <= int(FenCodec::Error::BISHOPSEAT); ++error)
+        if (errorCounts[error] > 0)
+            out << QString("  %1: %2").arg(FenCodec::errorString(FenCodec::Error(error))).arg(errorCounts[error])
+                << Qt::endl;
+    out << QString("  解码 %1 ms, %2 局面/秒; 编码 %3 ms, %4 局面/秒")
+               .arg(decodeNsecs / 1000000)
+               .arg(qint64(fenCount) * 1000000000 / qMax(decodeNsecs, qint64(1)))
+               .arg(encodeNsecs / 1000000)
+               .arg(qint64(validCount) * 1000000000 / qMax(encodeNsecs, qint64(1)))
+        << Qt::endl;
+}
+
+// 搜索引擎基准测试工具
+// bench [-d 深度] [-t 毫秒] [-m 置换表MB] [-j 线程数] [-s] [-f 文件] [FEN...]
+// 逐个局面搜索, 输出最佳着法、分值、主要变例及每秒结点数;
+// -s: 以固定深度分别用单线程与指定线程数搜索, 输出用时加速比
+// -f 文件: 不搜索, 只测试文件中全部FEN的批量编解码吞吐量
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Bench: 搜索引擎基准测试");
+    parser.addHelpOption();
+    QCommandLineOption depthOption({ "d", "depth" }, "搜索深度(默认6)", "depth", "6");
+    QCommandLineOption timeOption({ "t", "time" }, "每局面搜索时间(毫秒, 默认不限)", "msecs", "0");
+    QCommandLineOption hashOption({ "m", "hash" }, "置换表大小(MB, 默认16)", "megabytes",
+        QString::number(TranspositionTable::DEFAULTMB));
+    QCommandLineOption threadsOption({ "j", "threads" }, "搜索线程数(默认为处理器核心数)", "threads",
+        QString::number(SearchThreads::idealThreadCount()));
+    QCommandLineOption speedupOption({ "s", "speedup" }, "比较单线程与多线程的固定深度用时");
+    QCommandLineOption fenOption({ "f", "fen" }, "测试文件中FEN(每行一个)的编解码吞吐量", "file");
+    parser.addOptions({ depthOption, timeOption, hashOption, threadsOption, speedupOption, fenOption });
+    parser.addPositionalArgument("fen", "局面FEN及走棋方, 可多个(默认为perft参考局面)");
+    parser.process(app);
+
+    if (parser.isSet(fenOption)) {
+        runFenBench(out, parser.value(fenOption));
+        return 0;
+    }
+
+    QStringList fens { parser.positionalArguments() };
+    if (fens.isEmpty())
+        for (auto& reference : Perft::REFERENCES)
+            fens.append(reference.fen);
+
+    SearchLimits limits { parser.value(depthOption).toInt(), parser.value(timeOption).toInt() };
+    TranspositionTable table(parser.value(hashOption).toInt());
+    int threadCount { qMax(parser.value(threadsOption).toInt(), 1) };
+    quint64 nodes { 0 };
+    if (!parser.isSet(speedupOption)) {
+        runBench(out, fens, limits, table, threadCount, nodes);
+        return 0;
+    }
+
+    limits.msecs = 0;
+    qint64 singleMsecs { runBench(out, fens, limits, table, 1, nodes) };
+    qint64 multiMsecs { runBench(out, fens, limits, table, threadCount, nodes) };
+    out << QString("深度%1, %2线程加速比: %3")
+               .arg(limits.depth)
+               .arg(threadCount)
+               .arg(double(singleMsecs) / multiMsecs, 0, 'f', 2)
+        << Qt::endl;
+
+    return 0;
+}
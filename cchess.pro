@@ -11,7 +11,7 @@ LIBS += -lGdi32
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
-CONFIG += c++11
+CONFIG += c++17
 
 # The following define makes your compiler emit warnings if you use
 # any Qt feature that has been marked deprecated (the exact warnings
@@ -19,12 +19,16 @@ CONFIG += c++11
 # deprecated API in order to know how to port your code away from it.
 DEFINES += QT_DEPRECATED_WARNINGS
 
+# 位棋盘走子后端(qmake "CONFIG+=bitboard"), 见src/bitboard.h
+bitboard: DEFINES += CCHESS_BITBOARD
+
 # You can also make your code fail to compile if it uses deprecated APIs.
 # In order to do so, uncomment the following line.
 # You can also select to disable deprecated APIs only up to a certain version of Qt.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    src/annotator.cpp \
     src/aspect.cpp \
     src/board.cpp \
     src/boardpieces.cpp \
@@ -34,6 +38,9 @@ SOURCES += \
     src/command.cpp \
     src/common.cpp \
     src/database.cpp \
+    src/engine.cpp \
+    src/evaluation.cpp \
+    src/fencodec.cpp \
     src/main.cpp \
     src/mainwindow.cpp \
     src/manual.cpp \
@@ -41,19 +48,33 @@ SOURCES += \
     src/manualmove.cpp \
     src/manualmoveiterator.cpp \
     src/manualsubwindow.cpp \
+    src/matesolver.cpp \
     src/move.cpp \
     src/moveitem.cpp \
+    src/moveorder.cpp \
     src/moveview.cpp \
+    src/perft.cpp \
     src/piece.cpp \
     src/piecebase.cpp \
     src/pieceitem.cpp \
+    src/position.cpp \
+    src/repetition.cpp \
+    src/searchthreads.cpp \
     src/seat.cpp \
     src/seatbase.cpp \
+    src/tablebase.cpp \
+    src/tablebasegenerator.cpp \
     src/test.cpp \
-    src/tools.cpp
+    src/tools.cpp \
+    src/transpositiontable.cpp \
+    src/ucciclient.cpp \
+    src/ucciserver.cpp \
+    src/zhnotation.cpp
 
 HEADERS += \
+    src/annotator.h \
     src/aspect.h \
+    src/bitboard.h \
     src/board.h \
     src/boardpieces.h \
     src/boardscene.h \
@@ -62,22 +83,39 @@ HEADERS += \
     src/command.h \
     src/common.h \
     src/database.h \
+    src/engine.h \
+    src/evaluation.h \
+    src/fencodec.h \
     src/mainwindow.h \
     src/manual.h \
     src/manualIO.h \
     src/manualmove.h \
     src/manualmoveiterator.h \
     src/manualsubwindow.h \
+    src/matesolver.h \
     src/move.h \
     src/moveitem.h \
+    src/movelist.h \
+    src/moveorder.h \
     src/moveview.h \
+    src/perft.h \
     src/piece.h \
     src/piecebase.h \
     src/pieceitem.h \
+    src/position.h \
+    src/repetition.h \
+    src/searchthreads.h \
     src/seat.h \
     src/seatbase.h \
+    src/seattable.h \
+    src/tablebase.h \
+    src/tablebasegenerator.h \
     src/test.h \
-    src/tools.h
+    src/tools.h \
+    src/transpositiontable.h \
+    src/ucciclient.h \
+    src/ucciserver.h \
+    src/zhnotation.h
 
 FORMS += \
     src/mainwindow.ui \
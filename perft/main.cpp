@@ -0,0 +1,87 @@
+#include "board.h"
+#include "perft.h"
+#include "piece.h"
+#include "piecebase.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTextStream>
+
+// 走子生成验证与计时工具
+// perft [-d 深度] [FEN]: 分着法输出叶结点数, 及合计结点数、每秒结点数
+// perft -c [-d 深度]: 按参考局面逐深度验证, 有不符时返回1
+// 输出首行注明走子后端(数组/位棋盘), 以便比较两种构建
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Perft: 走子生成叶结点计数");
+    parser.addHelpOption();
+    QCommandLineOption depthOption({ "d", "depth" }, "搜索深度(默认4)", "depth", "4");
+    QCommandLineOption checkOption({ "c", "check" }, "按参考局面验证");
+    parser.addOptions({ depthOption, checkOption });
+    parser.addPositionalArgument("fen", "局面FEN及走棋方(默认初始局面)");
+    parser.process(app);
+
+    int depth { qMax(parser.value(depthOption).toInt(), 1) };
+    QElapsedTimer timer;
+    Board board {};
+    PieceColor color;
+#ifdef CCHESS_BITBOARD
+    out << "走子后端: 位棋盘" << Qt::endl;
+#else
+    out << "走子后端: 数组" << Qt::endl;
+#endif
+    if (parser.isSet(checkOption)) {
+        bool passed { true };
+        for (auto& reference : Perft::REFERENCES) {
+            if (!Perft::setFEN(board, reference.fen, color))
+                return 1;
+
+            out << reference.fen << Qt::endl;
+            for (int d = 1; d <= qMin(depth, 5); ++d) {
+                timer.start();
+                quint64 nodes { Perft::perft(board.position(), color, d) };
+                qint64 msecs { qMax(timer.elapsed(), qint64(1)) };
+                bool ok { nodes == reference.nodes[d - 1] };
+                passed = passed && ok;
+                out << QString("  %1: %2 %3 (%4 ms, %5 nps)")
+                           .arg(d)
+                           .arg(nodes)
+                           .arg(ok ? "ok" : QString("失败, 应为%1").arg(reference.nodes[d - 1]))
+                           .arg(msecs)
+                           .arg(nodes * 1000 / msecs)
+                    << Qt::endl;
+            }
+        }
+
+        return passed ? 0 : 1;
+    }
+
+    QStringList args { parser.positionalArguments() };
+    QString fen { args.isEmpty() ? PieceBase::FENSTR + " w" : args.join(' ') };
+    if (!Perft::setFEN(board, fen, color)) {
+        out << "FEN错误: " << fen << Qt::endl;
+        return 1;
+    }
+
+    timer.start();
+    quint64 total { 0 };
+    for (auto& moveNodes : Perft::divide(board.position(), color, depth)) {
+        out << Perft::moveString(moveNodes.first) << ": " << moveNodes.second << Qt::endl;
+        total += moveNodes.second;
+    }
+
+    qint64 msecs { qMax(timer.elapsed(), qint64(1)) };
+    out << QString("\n深度%1: %2 结点, %3 ms, %4 nps")
+               .arg(depth)
+               .arg(total)
+               .arg(msecs)
+               .arg(total * 1000 / msecs)
+        << Qt::endl;
+
+    return 0;
+}
@@ -0,0 +1,160 @@
+#include "annotator.h"
+#include "board.h"
+#include "engine.h"
+#include "manual.h"
+#include "manualIO.h"
+#include "manualmove.h"
+#include "manualmoveiterator.h"
+#include "move.h"
+#include "piece.h"
+#include "piecebase.h"
+#include "seatbase.h"
+#include "tools.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QThread>
+#include <atomic>
+
+static const QString ANNOTATIONBEGIN { "〔评分: " };
+static const QString ANNOTATIONEND { "〕" };
+
+QString AnnotateStats::toString() const
+{
+    return QString("棋谱: %1, 局面: %2, 结点: %3 (%4/秒), 用时: %5毫秒")
+        .arg(manuals)
+        .arg(positions)
+        .arg(nodes)
+        .arg(nodes * 1000 / qMax(msecs, qint64(1)))
+        .arg(msecs);
+}
+
+Annotator::Annotator(const AnnotateLimits& limits, int threadCount, int tableMB)
+    : limits_(limits)
+    , threadCount_(qMax(threadCount, 1))
+    , table_(tableMB)
+{
+    Q_ASSERT(limits_.depth > 0 || limits_.nodes > 0);
+}
+
+int Annotator::annotate(Manual* manual)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // 收集走子后的局面(遍历时局面在走子之前, 试走取FEN后撤销)
+    QList<Job> jobs;
+    Board* board { manual->board() };
+    ManualMoveFirstNextIterator firstNextIter(manual->manualMove());
+    while (firstNextIter.hasNext()) {
+        Move* move = firstNextIter.next();
+        move->done();
+        jobs.append({ move, board->getFEN(), PieceBase::getOtherColor(move->color()), 0, 0, {}, false });
+        move->undo();
+    }
+
+    search(jobs);
+
+    int count { 0 };
+    for (const Job& job : jobs) {
+        // 局面未能设置的着法保留原注解
+        if (!job.searched)
+            continue;
+
+        ++count;
+        QString remark { removeAnnotation(job.move->remark()) };
+        if (!remark.isEmpty())
+            remark.append('\n');
+        job.move->setRemark(remark + annotation(job.score, job.depth, job.bestReply));
+    }
+
+    ++stats_.manuals;
+    stats_.positions += count;
+    stats_.msecs += timer.elapsed();
+    return count;
+}
+
+int Annotator::annotateDir(const QString& dirName, const QString& toDirName, StoreType storeType)
+{
+    QDir fromDir(dirName);
+    QString suffix { ManualIO::getSuffixName(storeType) };
+    int count { 0 };
+    std::function<void(const QString&, void*)> annotateFile__
+        = [&](const QString& fileName, void*) {
+              Manual manual;
+              if (!manual.read(fileName))
+                  return;
+
+              annotate(&manual);
+              QFileInfo fileInfo(QDir(toDirName).filePath(fromDir.relativeFilePath(fileName)));
+              QDir().mkpath(fileInfo.absolutePath());
+              if (manual.write(QString("%1/%2.%3").arg(fileInfo.absolutePath()).arg(fileInfo.completeBaseName()).arg(suffix)))
+                  ++count;
+          };
+
+    Tools::operateDir(dirName, annotateFile__, nullptr, true);
+    return count;
+}
+
+QString Annotator::annotation(int score, int depth, const QString& bestReply)
+{
+    QString scoreString { Engine::isMateScore(score) ? QString(score > 0 ? "胜" : "负") : QString::number(score) };
+    QString replyString { bestReply.isEmpty() ? QString() : QString(", 应着: %1").arg(bestReply) };
+    return QString("%1%2%3, 深度: %4%5").arg(ANNOTATIONBEGIN).arg(scoreString).arg(replyString).arg(depth).arg(ANNOTATIONEND);
+}
+
+QString Annotator::removeAnnotation(const QString& remark)
+{
+    static const QRegularExpression annotationRe {
+        QString("\\s*%1[^%2]*%2$").arg(QRegularExpression::escape(ANNOTATIONBEGIN)).arg(ANNOTATIONEND)
+    };
+
+    return QString(remark).remove(annotationRe);
+}
+
+void Annotator::search(QList<Job>& jobs)
+{
+    // 各线程依次领取局面; 置换表跨局面共享, 相邻局面的搜索结果可相互利用
+    table_.newSearch();
+    std::atomic<int> nextIndex { 0 };
+    std::atomic<quint64> nodes { 0 };
+    auto work = [&]() {
+        Board board {};
+        int index;
+        while ((index = nextIndex.fetch_add(1)) < jobs.count()) {
+            Job& job { jobs[index] };
+            if (!board.setFEN(job.fen, job.sideColor))
+                continue;
+
+            Engine engine(board.position(), &table_);
+            SearchResult result { engine.search({ limits_.depth, 0, limits_.nodes }) };
+            nodes += result.nodes;
+            // 未完成任何一次迭代, 不作批注
+            if (result.depth == 0)
+                continue;
+
+            // 分值转为走子方(对方的前一着)视角
+            job.score = -result.score;
+            job.depth = result.depth;
+            if (result.bestMove)
+                job.bestReply = board.getZhStr(board.getSeatPair({ SeatBase::getCoord(MoveList::fromIndex(result.bestMove)),
+                    SeatBase::getCoord(MoveList::toIndex(result.bestMove)) }));
+            job.searched = true;
+        }
+    };
+
+    QList<QThread*> threads;
+    for (int index = 1; index < threadCount_; ++index) {
+        threads.append(QThread::create(work));
+        threads.last()->start();
+    }
+
+    work();
+    for (QThread* thread : threads) {
+        thread->wait();
+        delete thread;
+    }
+    stats_.nodes += nodes;
+}
@@ -0,0 +1,73 @@
+#ifndef ANNOTATOR_H
+#define ANNOTATOR_H
+// 棋谱批注(无界面): 逐着评价走子后的局面, 将走子方视角的分值与对方最佳应着以固定格式附于注释之后.
+// 主线程用ManualMoveFirstNextIterator遍历着法, 收集走子后局面的FEN; 各工作线程从共享序号依次取局面,
+// 在各自的Board上以独立引擎按深度或结点数搜索(共享置换表), 并将最佳应着转为中文着法.
+// 全部完成后由主线程写回注释, 再次批注时替换旧的批注.
+
+#include "searchthreads.h"
+#include "transpositiontable.h"
+
+#include <QList>
+#include <QString>
+
+class Manual;
+class Move;
+enum class PieceColor;
+enum class StoreType;
+
+// 每个局面的搜索限制: 深度、结点数, 0为不限(不可同时为0)
+struct AnnotateLimits {
+    int depth { 8 };
+    quint64 nodes { 0 };
+};
+
+// 累计统计: 棋谱数、局面数、搜索结点数、用时
+struct AnnotateStats {
+    int manuals { 0 };
+    int positions { 0 };
+    quint64 nodes { 0 };
+    qint64 msecs { 0 };
+
+    QString toString() const;
+};
+
+class Annotator {
+public:
+    static const int TABLEMB { 64 };
+
+    explicit Annotator(const AnnotateLimits& limits = {},
+        int threadCount = SearchThreads::idealThreadCount(), int tableMB = TABLEMB);
+
+    // 批注一局, 返回批注的着法数
+    int annotate(Manual* manual);
+    // 批注目录中的全部棋谱, 按原相对路径以指定格式写入另一目录, 返回批注的棋谱数
+    int annotateDir(const QString& dirName, const QString& toDirName, StoreType storeType);
+
+    const AnnotateStats& stats() const { return stats_; }
+
+    // 批注文字, 如"〔评分: 35, 应着: 炮二平五, 深度: 8〕"
+    static QString annotation(int score, int depth, const QString& bestReply);
+    // 注释中去掉已有的批注
+    static QString removeAnnotation(const QString& remark);
+
+private:
+    struct Job {
+        Move* move;
+        QString fen;
+        PieceColor sideColor;
+        int score;
+        int depth;
+        QString bestReply;
+        bool searched;
+    };
+
+    void search(QList<Job>& jobs);
+
+    AnnotateLimits limits_;
+    int threadCount_;
+    TranspositionTable table_;
+    AnnotateStats stats_ {};
+};
+
+#endif // ANNOTATOR_H
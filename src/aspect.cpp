@@ -131,7 +131,7 @@ void Aspects::read_(QTextStream& stream)
 
             evalMatch = evalMatchIter.next();
             for (auto& eval : evalMatch.captured(2).split(' ', Qt::SkipEmptyParts))
-                evalList.append(eval.toUInt());
+                evalList.append(eval.toInt());
 
             rowcolsMap[evalMatch.captured(1)] = evalList;
         }
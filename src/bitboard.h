@@ -0,0 +1,178 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+// 128位位棋盘: 90个位置按序号占低90位. 编译器支持SSE2(x86-64)时以__m128i存放, 否则以两个64位整数存放;
+// 多个位棋盘求并(如一方全部棋子的攻击位置)在支持AVX2时每次合并两个.
+// 另有行、列占位查表: 车、炮在某行(列)上的可走、攻击位置只取决于该行(列)的占位及其所在列(行),
+// 预计算为编译期常量表, 代替沿四个方向逐个位置查看.
+// 定义CCHESS_BITBOARD(qmake "CONFIG+=bitboard")时, Position以此维护占位并生成车炮着法、判断攻击.
+
+#include "seattable.h"
+
+#include <QtAlgorithms>
+#include <QtGlobal>
+
+#if defined(__SSE2__) && (defined(__x86_64__) || defined(_M_X64))
+#define CCHESS_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(CCHESS_SSE2) && defined(__AVX2__)
+#define CCHESS_AVX2
+#include <immintrin.h>
+#endif
+
+class Bitboard {
+public:
+    Bitboard() = default;
+#ifdef CCHESS_SSE2
+    Bitboard(quint64 low, quint64 high)
+        : bits_(_mm_set_epi64x(qint64(high), qint64(low)))
+    {
+    }
+
+    quint64 low() const { return quint64(_mm_cvtsi128_si64(bits_)); }
+    quint64 high() const { return quint64(_mm_cvtsi128_si64(_mm_unpackhi_epi64(bits_, bits_))); }
+    bool isEmpty() const { return _mm_movemask_epi8(_mm_cmpeq_epi8(bits_, _mm_setzero_si128())) == 0xFFFF; }
+
+    Bitboard operator|(const Bitboard& other) const { return Bitboard(_mm_or_si128(bits_, other.bits_)); }
+    Bitboard operator&(const Bitboard& other) const { return Bitboard(_mm_and_si128(bits_, other.bits_)); }
+    Bitboard operator^(const Bitboard& other) const { return Bitboard(_mm_xor_si128(bits_, other.bits_)); }
+#else
+    Bitboard(quint64 low, quint64 high)
+        : low_(low)
+        , high_(high)
+    {
+    }
+
+    quint64 low() const { return low_; }
+    quint64 high() const { return high_; }
+    bool isEmpty() const { return (low_ | high_) == 0; }
+
+    Bitboard operator|(const Bitboard& other) const { return { low_ | other.low_, high_ | other.high_ }; }
+    Bitboard operator&(const Bitboard& other) const { return { low_ & other.low_, high_ & other.high_ }; }
+    Bitboard operator^(const Bitboard& other) const { return { low_ ^ other.low_, high_ ^ other.high_ }; }
+#endif
+
+    Bitboard& operator|=(const Bitboard& other) { return *this = *this | other; }
+    Bitboard& operator&=(const Bitboard& other) { return *this = *this & other; }
+    Bitboard& operator^=(const Bitboard& other) { return *this = *this ^ other; }
+
+    static Bitboard zero() { return { 0, 0 }; }
+    static Bitboard seat(int index)
+    {
+        return index < 64 ? Bitboard(quint64(1) << index, 0) : Bitboard(0, quint64(1) << (index - 64));
+    }
+
+    // 某行的位掩码(每行SeatTable::COLNUM位)置于该行位置
+    static Bitboard rowBits(int row, quint64 bits)
+    {
+        int shift { row * SeatTable::COLNUM };
+        return shift < 64 ? Bitboard(bits << shift, shift == 0 ? 0 : bits >> (64 - shift))
+                          : Bitboard(0, bits << (shift - 64));
+    }
+
+    bool test(int index) const
+    {
+        return index < 64 ? (low() >> index) & 1 : (high() >> (index - 64)) & 1;
+    }
+
+    int count() const { return int(qPopulationCount(low()) + qPopulationCount(high())); }
+
+    // 取出序号最小的位置(须非空)
+    int takeFirst()
+    {
+        quint64 lowBits { low() }, highBits { high() };
+        if (lowBits) {
+            *this = { lowBits & (lowBits - 1), highBits };
+            return int(qCountTrailingZeroBits(lowBits));
+        }
+
+        *this = { 0, highBits & (highBits - 1) };
+        return 64 + int(qCountTrailingZeroBits(highBits));
+    }
+
+    // 多个位棋盘之并
+    static Bitboard unite(const Bitboard* boards, int count)
+    {
+#if defined(CCHESS_AVX2)
+        __m256i bits { _mm256_setzero_si256() };
+        int index { 0 };
+        for (; index + 2 <= count; index += 2)
+            bits = _mm256_or_si256(bits, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(boards + index)));
+        __m128i result { _mm_or_si128(_mm256_castsi256_si128(bits), _mm256_extracti128_si256(bits, 1)) };
+        if (index < count)
+            result = _mm_or_si128(result, boards[index].bits_);
+        return Bitboard(result);
+#else
+        Bitboard result { zero() };
+        for (int index = 0; index < count; ++index)
+            result |= boards[index];
+        return result;
+#endif
+    }
+
+private:
+#ifdef CCHESS_SSE2
+    explicit Bitboard(__m128i bits)
+        : bits_(bits)
+    {
+    }
+
+    __m128i bits_;
+#else
+    quint64 low_;
+    quint64 high_;
+#endif
+};
+
+namespace SeatTable {
+
+// 车、炮在一行(列)上的走法: 按所在列(行)及该行(列)占位查表, 结果为该行(列)内的位掩码
+struct LineMoves {
+    quint16 rook; // 各方向至第一个棋子(含)为止
+    quint16 cannon; // 各方向至第一个棋子(不含)为止, 及越过炮架后的第一个棋子
+    quint16 cannonAttack; // 越过炮架后至下一个棋子(含)为止
+};
+
+template <int N>
+struct LineTable {
+    LineMoves moves[N][1 << N];
+};
+
+template <int N>
+constexpr LineTable<N> makeLineTable()
+{
+    LineTable<N> table {};
+    for (int pos = 0; pos < N; ++pos)
+        for (int occupancy = 0; occupancy < (1 << N); ++occupancy) {
+            LineMoves& moves { table.moves[pos][occupancy] };
+            for (int step : { -1, 1 }) {
+                bool screened { false }; // 是否已越过炮架
+                for (int to = pos + step; to >= 0 && to < N; to += step) {
+                    int bit { 1 << to };
+                    bool has { (occupancy & bit) != 0 };
+                    if (!screened) {
+                        moves.rook |= bit;
+                        if (has)
+                            screened = true;
+                        else
+                            moves.cannon |= bit;
+                    } else {
+                        moves.cannonAttack |= bit;
+                        if (has) {
+                            moves.cannon |= bit;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+
+    return table;
+}
+
+inline constexpr LineTable<COLNUM> ROWLINETABLE { makeLineTable<COLNUM>() }; // 按列号、行占位
+inline constexpr LineTable<ROWNUM> COLLINETABLE { makeLineTable<ROWNUM>() }; // 按行号、列占位
+
+}
+
+#endif // BITBOARD_H
@@ -1,17 +1,19 @@
 #include "board.h"
-#include "aspect.h"
 #include "boardpieces.h"
 #include "boardseats.h"
+#include "evaluation.h"
 #include "piece.h"
 #include "piecebase.h"
+#include "position.h"
 #include "seat.h"
 #include "seatbase.h"
-#include "tools.h"
+#include "zhnotation.h"
+
+#include <QMap>
 
 Board::Board()
     : boardPieces_(new BoardPieces)
     , boardSeats_(new BoardSeats)
-    , bottomColor_(PieceColor::RED)
 {
     init();
 }
@@ -30,7 +32,9 @@ void Board::init()
         getSeat(coordPiece.first)->setPiece(boardPieces_->getNonLivePiece(color, kind));
     }
 
-    bottomColor_ = PieceColor::RED;
+    // 初始局面红方先走, 走棋方及其哈希键不沿用上一局面
+    position().setSideColor(PieceColor::RED);
+    position().setBottomColor(PieceColor::RED);
 }
 
 QList<Piece*> Board::getAllPieces() const
@@ -40,7 +44,7 @@ QList<Piece*> Board::getAllPieces() const
 
 QList<Seat*> Board::getLiveSeats() const
 {
-    return boardPieces_->getLiveSeats();
+    return boardPieces_->getLiveSeats().toList();
 }
 
 // test.cpp
@@ -51,12 +55,19 @@ Piece* Board::getPiece(Coord coord) const
 
 QList<Coord> Board::getLiveSeatCoordList(PieceColor color) const
 {
-    return getCoordList(boardPieces_->getLiveSeats(color));
+    return getCoordList(boardPieces_->getLiveSeats(color).toList());
 }
 
 QList<Coord> Board::getCanMoveCoords(const Coord& fromCoord) const
 {
-    return getCanMoveCoordLists(fromCoord).value(0);
+    MoveList moveList;
+    snapshot().generateLegalMoves(getSeat(fromCoord)->index(), moveList);
+
+    QList<Coord> coords;
+    for (PackedMove move : moveList)
+        coords.append(SeatBase::getCoord(MoveList::toIndex(move)));
+
+    return coords;
 }
 
 QList<QList<Coord>> Board::getCanMoveCoordLists(const Coord& fromCoord) const
@@ -67,7 +78,7 @@ QList<QList<Coord>> Board::getCanMoveCoordLists(const Coord& fromCoord) const
 QMap<Seat*, QList<Coord>> Board::getColorCanMoveCoords(PieceColor color) const
 {
     QMap<Seat*, QList<Coord>> seatCoords;
-    for (auto& fromSeat : boardPieces_->getLiveSeats(color))
+    for (Seat* fromSeat : boardPieces_->getLiveSeats(color))
         seatCoords[fromSeat] = getCanMoveCoords(fromSeat->coord());
 
     return seatCoords;
@@ -100,40 +111,34 @@ bool Board::canMove(const Coord& fromCoord, const Coord& toCoord) const
 
 bool Board::canMove(const SeatPair& seatPair) const
 {
-    return getCanMoveCoords(seatPair.first->coord()).contains(seatPair.second->coord());
+    if (!seatPair.first || !seatPair.second)
+        return false;
+
+    MoveList moveList;
+    int fromIndex { seatPair.first->index() };
+    snapshot().generateLegalMoves(fromIndex, moveList);
+
+    return moveList.contains(fromIndex, seatPair.second->index());
 }
 
 bool Board::isFace() const
 {
-    Seat* redSeat = boardPieces_->getKingSeat(PieceColor::RED);
-    Seat* blackSeat = boardPieces_->getKingSeat(PieceColor::BLACK);
-    Q_ASSERT(redSeat && blackSeat);
-
-    return boardSeats_->isFace(redSeat, blackSeat);
+    return position().isFace();
 }
 
 bool Board::isKilled(PieceColor color) const
 {
-    Seat* kingSeat = boardPieces_->getKingSeat(color);
-    Q_ASSERT(kingSeat);
-
-    Coord kingCoord = kingSeat->coord();
-    PieceColor otherColor = PieceBase::getOtherColor(color);
-    SeatSide otherHomeSide = getHomeSide(otherColor);
-    for (auto& fromSeat : boardPieces_->getLiveSeats(otherColor))
-        if (fromSeat->canMove(boardSeats_, otherHomeSide).value(0).contains(kingCoord))
-            return true;
-
-    return false;
+    return position().isKilled(color);
 }
 
 bool Board::isFailed(PieceColor color) const
 {
-    for (auto& fromSeat : boardPieces_->getLiveSeats(color))
-        if (!getCanMoveCoords(fromSeat->coord()).isEmpty())
-            return false;
+    return !snapshot().hasAnyLegalMove(color);
+}
 
-    return true;
+GameState Board::gameState() const
+{
+    return snapshot().gameState();
 }
 
 QString Board::getPieceChars() const
@@ -146,9 +151,53 @@ QString Board::getFEN() const
     return boardSeats_->getFEN();
 }
 
-bool Board::setFEN(const QString& fen)
+bool Board::setFEN(const QString& fen, PieceColor sideColor)
+{
+    if (!boardSeats_->setFEN(boardPieces_, fen))
+        return false;
+
+    position().setSideColor(sideColor);
+    return setBottomColor();
+}
+
+quint64 Board::hash() const
+{
+    return position().hash();
+}
+
+Position Board::snapshot() const
+{
+    return position();
+}
+
+void Board::restore(const Position& position)
+{
+    boardSeats_->clear();
+    for (int pieceIndex = 0; pieceIndex < Position::PIECENUM; ++pieceIndex) {
+        int index { position.seatIndex(pieceIndex) };
+        if (index != Position::NOSEAT)
+            boardSeats_->getSeat(index)->setPiece(boardPieces_->getPiece(pieceIndex));
+    }
+
+    Position& boardPosition { this->position() };
+    boardPosition.setSideColor(position.sideColor());
+    boardPosition.setBottomColor(position.bottomColor());
+    Q_ASSERT(boardPosition.hash() == position.hash());
+}
+
+CanonicalKey Board::canonicalKey() const
 {
-    return boardSeats_->setFEN(boardPieces_, fen) && setBottomColor();
+    return position().canonicalKey();
+}
+
+int Board::getMoveValue(const SeatPair& seatPair) const
+{
+    Position pos { snapshot() };
+    int fromIndex { seatPair.first->index() }, toIndex { seatPair.second->index() };
+    PieceColor color { Position::color(pos.pieceIndex(fromIndex)) };
+    pos.movePiece(fromIndex, toIndex);
+
+    return Evaluation::evaluate(pos, color);
 }
 
 SeatPair Board::changeSeatPair(SeatPair seatPair, ChangeType ct) const
@@ -160,118 +209,29 @@ SeatPair Board::changeSeatPair(SeatPair seatPair, ChangeType ct) const
 bool Board::changeLayout(ChangeType ct)
 {
     boardSeats_->changeLayout(boardPieces_, ct);
+    // 对换颜色后, 原红方走棋即成黑方走棋
+    if (ct == ChangeType::EXCHANGE)
+        position().changeSide();
+
     return setBottomColor();
 }
 
 QString Board::getZhStr(const SeatPair& seatPair) const
 {
-    Seat* fseat { seatPair.first };
-    Seat* tseat { seatPair.second };
-    if (!fseat->hasPiece())
+    QChar zhChars[ZhNotation::ZHLENGTH];
+    if (!ZhNotation::encode(position(), seatPair.first->index(), seatPair.second->index(), zhChars))
         return {};
 
-    QString zhStr;
-    Piece* fromPiece { fseat->piece() };
-    PieceColor color { fromPiece->color() };
-    QChar name { fromPiece->name() };
-    int fromRow { fseat->row() }, fromCol { fseat->col() },
-        toRow { tseat->row() }, toCol { tseat->col() };
-    bool isSameRow { fromRow == toRow }, isBottom { color == bottomColor_ };
-    QList<Seat*> seats = boardPieces_->getLiveSeats(color, name, fromCol);
-
-    if (seats.size() > 1 && PieceBase::isStrongePiece(name)) {
-        bool isPawn = PieceBase::isPawnPiece(name);
-        if (isPawn)
-            seats = boardPieces_->getLiveSeats_SortPawn(color, isBottom);
-        else
-            // 按先行后列的顺序，从小到大排序
-            std::sort(seats.begin(), seats.end(), SeatBase::less);
-
-        // 如是兵，已根据是否底边排好序
-        bool tempIsBottom { isPawn ? false : isBottom };
-        QChar indexChar { PieceBase::getIndexChar(seats.size(), tempIsBottom, seats.indexOf(fseat)) };
-        zhStr.append(indexChar).append(name);
-    } else { //将帅, 仕(士),相(象): 不用“前”和“后”区别，因为能退的一定在前，能进的一定在后
-        QChar colChar { PieceBase::getColChar(color, isBottom, fromCol) };
-        zhStr.append(name).append(colChar);
-    }
-    bool lineNotSameRow { PieceBase::isLinePiece(name) && !isSameRow };
-    QChar movChar { PieceBase::getMovChar(isSameRow, isBottom, toRow > fromRow) },
-        toNumColChar { lineNotSameRow
-                ? PieceBase::getNumChar(color, abs(fromRow - toRow))
-                : PieceBase::getColChar(color, isBottom, toCol) };
-    zhStr.append(movChar).append(toNumColChar);
-
-    Q_ASSERT(getSeatPair(zhStr) == seatPair); //验证
-    return zhStr;
+    return QString(zhChars, ZhNotation::ZHLENGTH);
 }
 
 SeatPair Board::getSeatPair(const QString& zhStr) const
 {
-    SeatPair seatPair;
-    if (zhStr.size() != 4)
-        return seatPair;
-
-    // 根据最后一个字符判断该着法属于哪一方
-    PieceColor color { PieceBase::getColorFromZh(zhStr.back()) };
-    bool isBottom { color == bottomColor_ };
-    int index {}, movDir { PieceBase::getMovNum(isBottom, zhStr.at(2)) };
-    QChar name { zhStr.front() };
-    bool isMultPawn = false;
-
-    QList<Seat*> seats;
-    if (PieceBase::isPiece(name)) { // 首字符为棋子名
-        int fromNum { PieceBase::getNum(color, zhStr.at(1)) },
-            fromCol { PieceBase::getCol(isBottom, fromNum) };
-        seats = boardPieces_->getLiveSeats(color, name, fromCol);
-
-        //        if (seats.size() == 0)
-        //            return seatPair;
-
-        Q_ASSERT(seats.size() > 0);
-        //# 排除：士、象同列时不分前后，以进、退区分棋子。移动方向为退时，修正index
-        bool advBishopBack { seats.size() == 2 && movDir == -1 };
-        index = advBishopBack ? 1 : 0; //&& isAdvBish(name)
-    } else {
-        name = zhStr.at(1);
-        isMultPawn = PieceBase::isPawnPiece(name);
-        seats = (isMultPawn
-                ? boardPieces_->getLiveSeats_SortPawn(color, isBottom)
-                : boardPieces_->getLiveSeats(color, name));
-
-        //        if (seats.size() <= 1)
-        //            return seatPair;
-
-        Q_ASSERT(seats.size() > 1);
-        // 如是多兵，已根据是否底边排好序
-        index = PieceBase::getIndex(seats.size(), isMultPawn ? false : isBottom, zhStr.front());
-    }
-
-    //    if (index >= seats.size())
-    //        return seatPair;
-
-    Q_ASSERT(index <= seats.size() - 1);
-    if (!isMultPawn) // 如不是多兵，按先行后列的顺序，从小到大排序
-        std::sort(seats.begin(), seats.end(), SeatBase::less);
-
-    seatPair.first = seats.at(index);
-    int toNum { PieceBase::getNum(color, zhStr.back()) },
-        toRow { seatPair.first->row() },
-        toCol { PieceBase::getCol(isBottom, toNum) };
-    if (PieceBase::isLinePiece(name)) {
-        if (movDir != 0) {
-            toRow += movDir * toNum;
-            toCol = seatPair.first->col();
-        }
-    } else { // 斜线走子：仕、相、马
-        int colAway { abs(toCol - seatPair.first->col()) }, //  相距1或2列
-            rowInc { PieceBase::isAdvisorBishopPiece(name) ? colAway : (colAway == 1 ? 2 : 1) };
-        toRow += movDir * rowInc;
-    }
-    seatPair.second = getSeat({ toRow, toCol });
+    int fromIndex, toIndex;
+    if (zhStr.size() != ZhNotation::ZHLENGTH || !ZhNotation::decode(position(), zhStr.constData(), fromIndex, toIndex))
+        return {};
 
-    //    Q_ASSERT(zhStr == getZhStr(seatPair));
-    return seatPair;
+    return { getSeat(SeatBase::getCoord(fromIndex)), getSeat(SeatBase::getCoord(toIndex)) };
 }
 
 SeatPair Board::getSeatPair(const QPair<Coord, Coord>& coordlPair) const
@@ -281,7 +241,7 @@ SeatPair Board::getSeatPair(const QPair<Coord, Coord>& coordlPair) const
 
 QString Board::toString(bool hasEdge) const
 {
-    return boardSeats_->toString(bottomColor_, hasEdge);
+    return boardSeats_->toString(position().bottomColor(), hasEdge);
 }
 
 Seat* Board::getSeat(const Coord& coord) const
@@ -289,6 +249,16 @@ Seat* Board::getSeat(const Coord& coord) const
     return boardSeats_->getSeat(coord);
 }
 
+Position& Board::position()
+{
+    return boardSeats_->position();
+}
+
+const Position& Board::position() const
+{
+    return boardSeats_->position();
+}
+
 QList<QList<Coord>> Board::getCanMoveCoordLists(Seat* fromSeat) const
 {
     if (!fromSeat->hasPiece())
@@ -305,7 +275,8 @@ QList<QList<Coord>> Board::getCanMoveCoordLists(Seat* fromSeat) const
 
 QList<Coord> Board::filterKilledRule(Seat* fromSeat, QList<Coord>& coords) const
 {
-    //  排除将帅对面、被将军的位置
+    //  排除将帅对面、被将军的位置: 在局面副本上试走、撤销, 不改动位置与棋子对象
+    Position position { snapshot() };
     QList<Coord> killCoords;
     QMutableListIterator<Coord> coordIter(coords);
     while (coordIter.hasNext()) {
@@ -315,7 +286,7 @@ QList<Coord> Board::filterKilledRule(Seat* fromSeat, QList<Coord>& coords) const
         if (toSeat->hasPiece() && toSeat->piece()->kind() == PieceKind::KING)
             continue;
 
-        if (isFaceOrKilled(fromSeat, toSeat)) {
+        if (position.isFaceOrKilled(fromSeat->index(), toSeat->index())) {
             killCoords.append(coord);
             coordIter.remove();
         }
@@ -324,21 +295,9 @@ QList<Coord> Board::filterKilledRule(Seat* fromSeat, QList<Coord>& coords) const
     return killCoords;
 }
 
-bool Board::isFaceOrKilled(Seat* fromSeat, Seat* toSeat) const
-{
-    PieceColor color = fromSeat->piece()->color();
-    Piece* toPiece = toSeat->piece();
-
-    fromSeat->moveTo(toSeat);
-    bool result { isFace() || isKilled(color) };
-    toSeat->moveTo(fromSeat, toPiece);
-
-    return result;
-}
-
 SeatSide Board::getHomeSide(PieceColor color) const
 {
-    return color == bottomColor_ ? SeatSide::BOTTOM : SeatSide::TOP;
+    return position().getHomeSide(color);
 }
 
 bool Board::setBottomColor()
@@ -348,6 +307,6 @@ bool Board::setBottomColor()
     if (!redKingSeat)
         return false;
 
-    bottomColor_ = (redKingSeat->isBottom() ? PieceColor::RED : PieceColor::BLACK);
+    position().setBottomColor(redKingSeat->isBottom() ? PieceColor::RED : PieceColor::BLACK);
     return true;
 }
@@ -5,12 +5,15 @@
 
 class Seat;
 class BoardSeats;
+class Position;
+struct CanonicalKey;
 using Coord = QPair<int, int>;
 
 class Piece;
 class BoardPieces;
 enum class PieceColor;
 enum class PieceKind;
+enum class GameState;
 
 enum class SeatSide;
 enum class ChangeType;
@@ -46,10 +49,20 @@ public:
     bool isFace() const;
     bool isKilled(PieceColor color) const;
     bool isFailed(PieceColor color) const;
+    // 走棋方被杀、困毙或对局未结束
+    GameState gameState() const;
 
     QString getPieceChars() const;
     QString getFEN() const;
-    bool setFEN(const QString& fen);
+    bool setFEN(const QString& fen, PieceColor sideColor);
+
+    // 局面的Zobrist键(含走棋方), 随走子、置子增量更新
+    quint64 hash() const;
+    // 对称等价局面共用的规范键及所施变换
+    CanonicalKey canonicalKey() const;
+
+    // 走子后局面对走子方的静态评价(在局面副本上试走, 局面不变)
+    int getMoveValue(const SeatPair& seatPair) const;
 
     SeatSide getHomeSide(PieceColor color) const;
 
@@ -62,19 +75,26 @@ public:
 
     QString toString(bool hasEdge = false) const;
 
+    // 局面核心: 搜索、对弈等需在其上试走、撤销时取可修改引用(须走后撤销, 以免与位置、棋子对象不一致);
+    // 只读查询取常量引用, 需试走的常量查询在其值副本上进行
+    Position& position();
+    const Position& position() const;
+
+    // 局面核心的值副本, 及按副本重置棋盘(棋子对象按序号对应, 走棋方、底方一并恢复)
+    Position snapshot() const;
+    void restore(const Position& position);
+
 private:
     Seat* getSeat(const Coord& coord) const;
 
     QList<QList<Coord>> getCanMoveCoordLists(Seat* fromSeat) const;
 
     QList<Coord> filterKilledRule(Seat* fromSeat, QList<Coord>& coords) const;
-    bool isFaceOrKilled(Seat* fromSeat, Seat* toSeat) const;
 
     bool setBottomColor();
 
     BoardPieces* boardPieces_;
     BoardSeats* boardSeats_;
-    PieceColor bottomColor_;
 };
 
 #endif // BOARD_H
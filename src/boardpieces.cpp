@@ -3,136 +3,97 @@
 #include "piecebase.h"
 #include "seat.h"
 
-#include <QMap>
+int LiveSeats::count() const
+{
+    int count { 0 };
+    for (Piece* const* piece = first_; piece != last_; ++piece)
+        if ((*piece)->isLive())
+            ++count;
 
-BoardPieces::BoardPieces()
-    : pieces(Piece::creatPieces())
+    return count;
+}
+
+QList<Seat*> LiveSeats::toList() const
 {
+    QList<Seat*> seats;
+    for (Seat* seat : *this)
+        seats.append(seat);
+
+    return seats;
 }
 
-BoardPieces::~BoardPieces()
+BoardPieces::BoardPieces()
 {
-    for (auto& colorPieces : pieces)
+    for (auto& colorPieces : Piece::creatPieces())
         for (auto& kindPieces : colorPieces)
             for (auto& piece : kindPieces)
-                delete piece;
+                pieces_[piece->index()] = piece;
+}
+
+BoardPieces::~BoardPieces()
+{
+    for (Piece* piece : pieces_)
+        delete piece;
 }
 
 Piece* BoardPieces::getNonLivePiece(PieceColor color, PieceKind kind) const
 {
-    for (auto& piece : getPieces(color, kind))
-        if (!piece->isLive())
-            return piece;
+    for (int index = Position::firstPieceIndex(color, kind); index < Position::lastPieceIndex(color, kind); ++index)
+        if (!pieces_[index]->isLive())
+            return pieces_[index];
 
     Q_ASSERT("getNotLivePiece ? ");
     return {};
 }
 
+// 对方同种棋子中相同次序者: 两方棋子序号相差每方棋子数
 Piece* BoardPieces::getOtherPiece(Piece* piece) const
 {
     if (!piece)
         return piece;
 
-    PieceColor color = piece->color();
-    PieceKind kind = piece->kind();
-    int index = getPieces(color, kind).indexOf(piece);
-    return getPieces(PieceBase::getOtherColor(color), kind).at(index);
+    return pieces_[(piece->index() + Position::COLORPIECENUM) % Position::PIECENUM];
 }
 
 QList<Piece*> BoardPieces::getAllPieces() const
 {
     QList<Piece*> pieces;
-    for (PieceColor color : PieceBase::ALLCOLORS)
-        pieces.append(getPieces(color));
+    for (Piece* piece : pieces_)
+        pieces.append(piece);
 
     return pieces;
 }
 
 Seat* BoardPieces::getKingSeat(PieceColor color) const
 {
-    return getPieces(color, PieceKind::KING).at(0)->seat();
+    return pieces_[Position::firstPieceIndex(color, PieceKind::KING)]->seat();
 }
 
-QList<Seat*> BoardPieces::getLiveSeats() const
+LiveSeats BoardPieces::getLiveSeats() const
 {
-    return getLiveSeats(getAllPieces());
+    return { pieces_, pieces_ + Position::PIECENUM };
 }
 
-QList<Seat*> BoardPieces::getLiveSeats(PieceColor color) const
+LiveSeats BoardPieces::getLiveSeats(PieceColor color) const
 {
-    return getLiveSeats(getPieces(color));
+    return { pieces_ + int(color) * Position::COLORPIECENUM, pieces_ + (int(color) + 1) * Position::COLORPIECENUM };
 }
 
-QList<Seat*> BoardPieces::getLiveSeats(PieceColor color, PieceKind kind) const
+LiveSeats BoardPieces::getLiveSeats(PieceColor color, PieceKind kind) const
 {
-    return getLiveSeats(getPieces(color, kind));
+    return { pieces_ + Position::firstPieceIndex(color, kind), pieces_ + Position::lastPieceIndex(color, kind) };
 }
 
-QList<Seat*> BoardPieces::getLiveSeats(PieceColor color, QChar name) const
+LiveSeats BoardPieces::getLiveSeats(PieceColor color, QChar name) const
 {
     return getLiveSeats(color, PieceBase::getKind(color, name));
 }
 
-QList<Seat*> BoardPieces::getLiveSeats(PieceColor color, QChar name, int col) const
-{
-    QList<Seat*> seats { getLiveSeats(color, name) };
-    QMutableListIterator<Seat*> seatIter(seats);
-    while (seatIter.hasNext())
-        if (seatIter.next()->col() != col)
-            seatIter.remove();
-
-    return seats;
-}
-
-QList<Seat*> BoardPieces::getLiveSeats_SortPawn(PieceColor color, bool isBottom) const
-{
-    // 最多5个兵, 按列、行建立映射，按列、行排序
-    QMap<int, QMap<int, Seat*>> colRowSeats;
-    for (auto& seat : getLiveSeats(color, PieceKind::PAWN)) {
-        // 根据isBottom值排序
-        int col = seat->col(), row = seat->row();
-        colRowSeats[isBottom ? -col : col][isBottom ? -row : row] = seat;
-    }
-
-    QList<Seat*> seats;
-    for (auto& colSeats : colRowSeats.values()) {
-        // 只选取2个及以上的QMap
-        if (colSeats.size() > 1)
-            seats.append(colSeats.values());
-    }
-
-    return seats;
-}
-
 QString BoardPieces::toString() const
 {
     QString string;
-    for (auto& piece : getAllPieces())
+    for (Piece* piece : pieces_)
         string.append(piece->toString());
 
     return string;
 }
-
-QList<Piece*> BoardPieces::getPieces(PieceColor color) const
-{
-    QList<Piece*> pieces;
-    for (PieceKind kind : PieceBase::ALLKINDS)
-        pieces.append(getPieces(color, kind));
-
-    return pieces;
-}
-
-QList<Piece*> BoardPieces::getPieces(PieceColor color, PieceKind kind) const
-{
-    return pieces.at(int(color)).at(int(kind));
-}
-
-QList<Seat*> BoardPieces::getLiveSeats(const QList<Piece*>& pieces)
-{
-    QList<Seat*> seats;
-    for (auto& piece : pieces)
-        if (piece->isLive())
-            seats.append(piece->seat());
-
-    return seats;
-}
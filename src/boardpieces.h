@@ -1,19 +1,75 @@
 #ifndef BOARDPIECES_H
 #define BOARDPIECES_H
 
+#include "piece.h"
+#include "position.h"
+
 #include <QList>
 
 class Seat;
-class Piece;
-enum class PieceColor;
-enum class PieceKind;
 
-// 一副棋子类
+// 棋子序号区间中在棋盘上的棋子的位置视图: 遍历时跳过未在棋盘上的棋子, 不复制列表
+// 棋子是否在棋盘上由Seat::setPiece、moveTo随时更新, 视图始终反映当前局面
+class LiveSeats {
+public:
+    class Iterator {
+    public:
+        Iterator(Piece* const* piece, Piece* const* end)
+            : piece_(piece)
+            , end_(end)
+        {
+            skip();
+        }
+
+        Seat* operator*() const { return (*piece_)->seat(); }
+        Iterator& operator++()
+        {
+            ++piece_;
+            skip();
+            return *this;
+        }
+        bool operator!=(const Iterator& other) const { return piece_ != other.piece_; }
+
+    private:
+        void skip()
+        {
+            while (piece_ != end_ && !(*piece_)->isLive())
+                ++piece_;
+        }
+
+        Piece* const* piece_;
+        Piece* const* end_;
+    };
+
+    LiveSeats(Piece* const* first, Piece* const* last)
+        : first_(first)
+        , last_(last)
+    {
+    }
+
+    Iterator begin() const { return { first_, last_ }; }
+    Iterator end() const { return { last_, last_ }; }
+
+    int count() const;
+    bool isEmpty() const { return !(begin() != end()); }
+    QList<Seat*> toList() const;
+
+private:
+    Piece* const* first_;
+    Piece* const* last_;
+};
+
+// 一副棋子类: 按棋子序号(与Position一致)存放, 每方每种棋子占连续区间
 class BoardPieces {
 public:
     BoardPieces();
     ~BoardPieces();
 
+    BoardPieces(const BoardPieces&) = delete;
+    BoardPieces& operator=(const BoardPieces&) = delete;
+
+    Piece* getPiece(int pieceIndex) const { return pieces_[pieceIndex]; }
+
     // 取得未在棋盘上的棋子
     Piece* getNonLivePiece(PieceColor color, PieceKind kind) const;
     Piece* getOtherPiece(Piece* piece) const;
@@ -23,22 +79,15 @@ public:
 
     // 取得与棋子特征有关的位置
     Seat* getKingSeat(PieceColor color) const;
-    QList<Seat*> getLiveSeats() const;
-    QList<Seat*> getLiveSeats(PieceColor color) const;
-    QList<Seat*> getLiveSeats(PieceColor color, PieceKind kind) const;
-    QList<Seat*> getLiveSeats(PieceColor color, QChar name) const;
-    QList<Seat*> getLiveSeats(PieceColor color, QChar name, int col) const;
-    QList<Seat*> getLiveSeats_SortPawn(PieceColor color, bool isBottom) const;
+    LiveSeats getLiveSeats() const;
+    LiveSeats getLiveSeats(PieceColor color) const;
+    LiveSeats getLiveSeats(PieceColor color, PieceKind kind) const;
+    LiveSeats getLiveSeats(PieceColor color, QChar name) const;
 
     QString toString() const;
 
 private:
-    QList<Piece*> getPieces(PieceColor color) const;
-    QList<Piece*> getPieces(PieceColor color, PieceKind kind) const;
-
-    static QList<Seat*> getLiveSeats(const QList<Piece*>& pieces);
-
-    QList<QList<QList<Piece*>>> pieces;
+    Piece* pieces_[Position::PIECENUM];
 };
 
 #endif // BOARDPIECES_H
@@ -1,12 +1,13 @@
 #include "boardseats.h"
 #include "boardpieces.h"
+#include "fencodec.h"
 #include "piece.h"
 #include "piecebase.h"
 #include "seat.h"
 #include "seatbase.h"
 
 BoardSeats::BoardSeats()
-    : seats_(Seat::creatSeats())
+    : seats_(Seat::creatSeats(&position_))
 {
 }
 
@@ -71,11 +72,10 @@ void BoardSeats::changeLayout(const BoardPieces* boardPieces, ChangeType ct)
 
 QString BoardSeats::getPieceChars() const
 {
-    QString pieChars;
-    for (auto& seat : seats_)
-        pieChars.append(seat->hasPiece() ? seat->piece()->ch() : PieceBase::NULLCHAR);
+    QChar pieChars[FenCodec::SEATNUM];
+    writePieceChars(pieChars);
 
-    return pieChars;
+    return QString(pieChars, FenCodec::SEATNUM);
 }
 
 bool BoardSeats::setPieceChars(const BoardPieces* boardPieces, const QString& pieceChars)
@@ -83,42 +83,44 @@ bool BoardSeats::setPieceChars(const BoardPieces* boardPieces, const QString& pi
     if (pieceChars.size() != seats_.size())
         return false;
 
-    clear();
-    int index = 0;
-    for (auto& seat : seats_) {
-        QChar ch = pieceChars.at(index++);
-        if (ch != PieceBase::NULLCHAR)
-            seat->setPiece(boardPieces->getNonLivePiece(PieceBase::getColor(ch), PieceBase::getKind(ch)));
-    }
-
+    readPieceChars(boardPieces, pieceChars.constData());
     //    Q_ASSERT(pieceChars == getPieceChars());
     return true;
 }
 
 QString BoardSeats::getFEN() const
 {
-    return SeatBase::pieCharsToFEN(getPieceChars());
+    QChar pieChars[FenCodec::SEATNUM], fen[FenCodec::MAXLENGTH];
+    writePieceChars(pieChars);
+
+    return QString(fen, FenCodec::encode(pieChars, fen));
 }
 
 bool BoardSeats::setFEN(const BoardPieces* boardPieces, const QString& fen)
 {
-    return setPieceChars(boardPieces, SeatBase::FENToPieChars(fen));
+    // 解码于栈上缓冲区并校验, 不合格时不改变棋盘
+    QChar pieChars[FenCodec::SEATNUM];
+    if (FenCodec::decode(fen.constData(), fen.size(), pieChars) != FenCodec::Error::NONE)
+        return false;
+
+    readPieceChars(boardPieces, pieChars);
+    return true;
 }
 
-bool BoardSeats::isFace(Seat* redSeat, Seat* blackSeat) const
+void BoardSeats::writePieceChars(QChar* pieChars) const
 {
-    int col { redSeat->col() };
-    if (col != blackSeat->col())
-        return false;
-
-    int redRow = redSeat->row(), blackRow = blackSeat->row();
-    int lowRow { qMin(redRow, blackRow) },
-        upRow { qMax(redRow, blackRow) };
-    for (int row = lowRow + 1; row < upRow; ++row)
-        if (getSeat({ row, col })->hasPiece())
-            return false;
+    for (auto& seat : seats_)
+        *pieChars++ = seat->hasPiece() ? seat->piece()->ch() : PieceBase::NULLCHAR;
+}
 
-    return true;
+void BoardSeats::readPieceChars(const BoardPieces* boardPieces, const QChar* pieChars)
+{
+    clear();
+    PieceColor color;
+    PieceKind kind;
+    for (auto& seat : seats_)
+        if (FenCodec::colorKind(*pieChars++, color, kind))
+            seat->setPiece(boardPieces->getNonLivePiece(color, kind));
 }
 
 QString BoardSeats::toString(PieceColor bottomColor, bool hasEdge) const
@@ -1,6 +1,8 @@
 #ifndef BOARDSEATS_H
 #define BOARDSEATS_H
 
+#include "position.h"
+
 #include <QList>
 
 class Seat;
@@ -20,6 +22,9 @@ public:
     ~BoardSeats();
 
     void clear();
+    Position& position() { return position_; }
+    const Position& position() const { return position_; }
+
     Seat* getSeat(int index) const;
     Seat* getSeat(const Coord& coord) const;
 
@@ -31,11 +36,15 @@ public:
 
     QString getFEN() const;
     bool setFEN(const BoardPieces* boardPieces, const QString& fen);
-    bool isFace(Seat* redSeat, Seat* blackSeat) const;
 
     QString toString(PieceColor bottomColor, bool hasEdge) const;
 
 private:
+    // 按位置序号读写棋子字符数组(FenCodec::SEATNUM个)
+    void writePieceChars(QChar* pieChars) const;
+    void readPieceChars(const BoardPieces* boardPieces, const QChar* pieChars);
+
+    Position position_ {};
     QList<Seat*> seats_ {};
 };
 
@@ -1,4 +1,5 @@
 #include "database.h"
+#include "board.h"
 #include "boardpieces.h"
 #include "manual.h"
 #include "manualIO.h"
@@ -6,8 +7,11 @@
 #include "move.h"
 #include "piece.h"
 #include "piecebase.h"
+#include "position.h"
 #include "seat.h"
+#include "seatbase.h"
 #include "tools.h"
+#include "zhnotation.h"
 
 #include <QDebug>
 #include <QFile>
@@ -181,8 +185,10 @@ void DataBase::setRowcolsXqbaseManual(bool setNull)
     QList<InfoMap> infoMapList = {};
     while (query.next()) {
         InfoMap infoMap {};
+        // 读入已有结果, 以免按终局判定的结果覆盖
         for (auto& name : { ManualIO::getInfoName(InfoIndex::SOURCE),
-                 ManualIO::getInfoName(InfoIndex::MOVESTR) }) {
+                 ManualIO::getInfoName(InfoIndex::MOVESTR),
+                 ManualIO::getInfoName(InfoIndex::RESULT) }) {
             //        for (auto& name : InstanceIO::getAllInfoName()) {
             auto value = query.value(name);
             if (value.isValid())
@@ -1003,19 +1009,90 @@ QList<InfoMap> DataBase::downXqbaseManual_(const QList<int>& idList)
     return infoMapList;
 }
 
-void DataBase::setRowcols_(QList<InfoMap>& infoMapList)
+// 着法字符串的主线部分: 略去注解{...}及变着(...)
+static QString getMainMoveStr(const QString& moveStr)
 {
-    std::function<void(InfoMap&)> insideSetRowcols_ = [](InfoMap& infoMap) {
-        Manual manual(infoMap);
-        //        QString pgnString;
-        //        InstanceIO::constructPGN_String(infoMap, pgnString);
-        //        InstanceIO::parsePGN_String(&manual, pgnString);
-        //        ManualIO::read(&manual, infoMap);
-        //        manual.read(infoMap);
-        infoMap[ManualIO::getInfoName(InfoIndex::ROWCOLS)] = manual.getECCORowcols();
-    };
+    QString mainStr;
+    int remarkDepth { 0 }, otherDepth { 0 };
+    for (QChar ch : moveStr) {
+        if (ch == '{')
+            ++remarkDepth;
+        else if (ch == '}')
+            remarkDepth = qMax(remarkDepth - 1, 0);
+        else if (remarkDepth == 0 && ch == '(')
+            ++otherDepth;
+        else if (remarkDepth == 0 && ch == ')')
+            otherDepth = qMax(otherDepth - 1, 0);
+        else if (remarkDepth == 0 && otherDepth == 0)
+            mainStr.append(ch);
+    }
 
-    QtConcurrent::blockingMap(infoMapList, insideSetRowcols_);
+    return mainStr;
+}
+
+// 主线终局走棋方被杀或困毙, 而棋谱未记结果时, 记为对方胜
+static void setGameResult(InfoMap& infoMap, Position& position)
+{
+    QString resultName { ManualIO::getInfoName(InfoIndex::RESULT) };
+    QString result { infoMap.value(resultName) };
+    if (!result.isEmpty() && result != "未知")
+        return;
+
+    QString gameResult { Manual::getGameResult(position.gameState(), position.sideColor()) };
+    if (!gameResult.isEmpty())
+        infoMap[resultName] = gameResult;
+}
+
+void DataBase::setRowcols(InfoMap& infoMap)
+{
+    // 全局开局的棋谱: 复制初始局面的值快照并按FEN设定走棋方, 在其上解码主线中文着法并走子, 不必构造完整棋谱
+    static const Position initPosition { Board().snapshot() };
+    static const QRegularExpression zhReg(QString("[%1]{%2}").arg(PieceBase::getZhChars()).arg(ZhNotation::ZHLENGTH),
+        QRegularExpression::UseUnicodePropertiesOption);
+    QString fen { infoMap.value(ManualIO::getInfoName(InfoIndex::FEN)) };
+    if (fen.isEmpty() || fen.section(' ', 0, 0) == PieceBase::FENSTR) {
+        Position position { initPosition };
+        if (fen.section(' ', 1, 1) == "b")
+            position.setSideColor(PieceColor::BLACK);
+
+        QList<CoordPair> coordPairs;
+        QString moveStr { getMainMoveStr(infoMap.value(ManualIO::getInfoName(InfoIndex::MOVESTR))) };
+        bool isComplete { true };
+        auto matchIter = zhReg.globalMatch(moveStr);
+        while (matchIter.hasNext()) {
+            int fromIndex, toIndex;
+            if (!ZhNotation::decode(position, moveStr.constData() + matchIter.next().capturedStart(),
+                    fromIndex, toIndex)
+                || !position.isLegalMove(MoveList::pack(fromIndex, toIndex))) {
+                isComplete = false;
+                break;
+            }
+
+            position.movePiece(fromIndex, toIndex);
+            coordPairs.append({ SeatBase::getCoord(fromIndex), SeatBase::getCoord(toIndex) });
+        }
+        infoMap[ManualIO::getInfoName(InfoIndex::ROWCOLS)] = Manual::getECCORowcols(coordPairs);
+        // 主线未能完整解码时, 终局未知
+        if (isComplete)
+            setGameResult(infoMap, position);
+        return;
+    }
+
+    Manual manual(infoMap);
+    //        QString pgnString;
+    //        InstanceIO::constructPGN_String(infoMap, pgnString);
+    //        InstanceIO::parsePGN_String(&manual, pgnString);
+    //        ManualIO::read(&manual, infoMap);
+    //        manual.read(infoMap);
+    infoMap[ManualIO::getInfoName(InfoIndex::ROWCOLS)] = manual.getECCORowcols();
+    manual.manualMove()->goEnd();
+    Position position { manual.board()->snapshot() };
+    setGameResult(infoMap, position);
+}
+
+void DataBase::setRowcols_(QList<InfoMap>& infoMapList)
+{
+    QtConcurrent::blockingMap(infoMapList, setRowcols);
 }
 
 QString DataBase::getFieldNames_(const QStringList& names,
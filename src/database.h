@@ -52,6 +52,8 @@ public:
     // 读取或存入棋谱
     void insertInfoMap(const InfoMap& infoMap) const;
     static InfoMap getInfoMap(const QSqlRecord& record);
+    // 按棋谱信息的FEN和着法设置ROWCOLS, 主线终局已分胜负而未记结果时设置结果
+    static void setRowcols(InfoMap& infoMap);
 
     QString getTitleName(QItemSelectionModel*& insItemSelModel) const;
     static QString getTitleName(const InfoMap& infoMap);
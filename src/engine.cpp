@@ -0,0 +1,299 @@
+#include "engine.h"
+#include "evaluation.h"
+#include "piece.h"
+
+static const int NULLREDUCTION { 2 };
+static const int LMRMINDEPTH { 3 };
+static const int LMRMINMOVES { 3 };
+static const int CHECKNODES { 1023 }; // 每隔若干结点检查一次时间
+
+static_assert(MoveOrder::MAXPLY >= Engine::MAXPLY, "着法排序表层数不足");
+
+Engine::Engine(const Position& position, TranspositionTable* table, std::atomic<bool>* stopFlag)
+    : position_(position)
+    , table_(table ? table : new TranspositionTable)
+    , ownTable_(!table)
+    , stop_(stopFlag ? stopFlag : &ownStop_)
+{
+}
+
+Engine::~Engine()
+{
+    if (ownTable_)
+        delete table_;
+}
+
+SearchResult Engine::search(const SearchLimits& limits)
+{
+    limits_ = limits;
+    // 共享的停止标志由调用方复位
+    if (stop_ == &ownStop_)
+        ownStop_ = false;
+    nodes_ = 0;
+    prevPvLength_ = 0;
+    moveOrder_.newSearch();
+    if (ownTable_)
+        table_->newSearch();
+    timer_.start();
+
+    SearchResult result;
+    int maxDepth { limits.depth > 0 ? qMin(limits.depth, MAXPLY - 1) : MAXPLY - 1 };
+    for (int depth = qMin(startDepth_, maxDepth); depth <= maxDepth; ++depth) {
+        followPv_ = true;
+        int score { search(depth, -INFINITYSCORE, INFINITYSCORE, 0, false) };
+        // 未完成的迭代结果不可靠, 保留上次迭代的结果
+        if (stopped())
+            break;
+
+        result.depth = depth;
+        result.score = score;
+        result.pv.clear();
+        for (int ply = 0; ply < pvLength_[0]; ++ply) {
+            result.pv.append(pvTable_[0][ply]);
+            prevPv_[ply] = pvTable_[0][ply];
+        }
+        prevPvLength_ = pvLength_[0];
+        result.bestMove = result.pv.value(0);
+        if (iterationCallback_) {
+            result.nodes = nodes_;
+            result.msecs = timer_.elapsed();
+            iterationCallback_(result);
+        }
+
+        // 已找到杀着, 或剩余时间不足以完成下一次迭代
+        if (stopped() || isMateScore(score)
+            || (limits.msecs > 0 && timer_.elapsed() * 2 > limits.msecs))
+            break;
+    }
+
+    // 第一次迭代即被中止: 深度记为0, 以第一个合法着法作为着法
+    if (result.depth == 0) {
+        MoveList moveList;
+        position_.generateLegalMoves(position_.sideColor(), moveList);
+        if (!moveList.isEmpty())
+            result.bestMove = *moveList.begin();
+    }
+
+    result.nodes = nodes_;
+    result.msecs = timer_.elapsed();
+    result.orderStats = moveOrder_.stats();
+    return result;
+}
+
+int Engine::search(int depth, int alpha, int beta, int ply, bool allowNull)
+{
+    if (depth <= 0)
+        return quiesce(alpha, beta, ply);
+
+    ++nodes_;
+    pvLength_[ply] = ply;
+    if (checkStop())
+        return 0;
+
+    PieceColor color { position_.sideColor() };
+    if (ply >= MAXPLY - 1)
+        return evaluate();
+
+    // 重复局面: 违例方判负, 闲着循环判和
+    if (ply > 0) {
+        Repetition repetition { history_.check(position_) };
+        if (repetition.kind == RepetitionKind::IDLE)
+            return 0;
+        if (repetition.kind != RepetitionKind::NONE)
+            return repetition.loseColor == color ? -MATESCORE + ply : MATESCORE - ply;
+    }
+
+    bool isPv { beta - alpha > 1 }, inCheck { position_.isKilled(color) };
+    if (inCheck)
+        ++depth; // 将军延伸
+
+    // 置换表: 非主要变例结点可直接截断, 否则仅取其着法排序
+    quint64 hash { position_.hash() };
+    PackedMove hashMove { 0 };
+    TableEntry entry;
+    if (table_->probe(hash, entry)) {
+        hashMove = entry.move;
+        int score { scoreFromTable(entry.score, ply) };
+        if (!isPv && ply > 0 && entry.depth >= depth
+            && (entry.bound == Bound::EXACT
+                || (entry.bound == Bound::LOWER && score >= beta)
+                || (entry.bound == Bound::UPPER && score <= alpha)))
+            return score;
+    }
+
+    // 空着裁剪: 让对方连走仍不低于beta, 则本结点可裁剪
+    if (allowNull && !isPv && !inCheck && depth > NULLREDUCTION
+        && hasNullMaterial(color) && evaluate() >= beta) {
+        plyMoves_[ply] = 0;
+        history_.push(hash, 0, true); // 空着视同吃子, 重复判别不越过
+        position_.changeSide();
+        int score { -search(depth - 1 - NULLREDUCTION, -beta, -beta + 1, ply + 1, false) };
+        position_.changeSide();
+        history_.pop();
+        if (stopped())
+            return 0;
+
+        if (score >= beta)
+            return beta;
+    }
+
+    PackedMove pvMove { followPv_ && ply < prevPvLength_ ? prevPv_[ply] : PackedMove(0) };
+    followPv_ = pvMove != 0;
+    MoveList moveList;
+    generateMoves(moveList, MoveStage::ALL, pvMove ? pvMove : hashMove, ply);
+    if (moveList.isEmpty())
+        return -MATESCORE + ply; // 将死或困毙均判负
+
+    int originAlpha { alpha }, bestScore { -INFINITYSCORE }, moveCount { 0 }, quietCount { 0 };
+    PackedMove bestMove { 0 };
+    PackedMove quietMoves[MoveList::MAXCOUNT];
+    for (PackedMove move : moveList) {
+        int fromIndex { MoveList::fromIndex(move) }, toIndex { MoveList::toIndex(move) };
+        bool isCapture { position_.hasPiece(toIndex) };
+        plyMoves_[ply] = move;
+        history_.push(hash, move, isCapture);
+        int eatPieceIndex { position_.movePiece(fromIndex, toIndex) };
+        table_->prefetch(position_.hash());
+        int score;
+        if (++moveCount == 1)
+            score = -search(depth - 1, -beta, -alpha, ply + 1, true);
+        else {
+            // 排序靠后的不吃子、不将军着法先减少深度以空窗口试探
+            int reduction { (depth >= LMRMINDEPTH && moveCount > LMRMINMOVES && !isCapture
+                                && !inCheck && !position_.isKilled(position_.sideColor()))
+                    ? 1
+                    : 0 };
+            score = -search(depth - 1 - reduction, -alpha - 1, -alpha, ply + 1, true);
+            if (score > alpha && reduction > 0)
+                score = -search(depth - 1, -alpha - 1, -alpha, ply + 1, true);
+            if (score > alpha && score < beta)
+                score = -search(depth - 1, -beta, -alpha, ply + 1, true);
+        }
+        position_.undoMovePiece(fromIndex, toIndex, eatPieceIndex);
+        history_.pop();
+        followPv_ = false;
+        if (stopped())
+            return 0;
+
+        if (!isCapture)
+            quietMoves[quietCount++] = move;
+        if (score <= bestScore)
+            continue;
+
+        bestScore = score;
+        bestMove = move;
+        if (score <= alpha)
+            continue;
+
+        alpha = score;
+        pvTable_[ply][ply] = move;
+        for (int next = ply + 1; next < pvLength_[ply + 1]; ++next)
+            pvTable_[ply][next] = pvTable_[ply + 1][next];
+        pvLength_[ply] = pvLength_[ply + 1];
+        if (score >= beta) {
+            moveOrder_.updateCutoff(position_, move, ply, depth, ply > 0 ? plyMoves_[ply - 1] : PackedMove(0),
+                quietMoves, quietCount);
+            moveOrder_.recordCutoff(moveCount);
+            break;
+        }
+    }
+
+    Bound bound { bestScore >= beta ? Bound::LOWER
+            : bestScore > originAlpha ? Bound::EXACT
+                                      : Bound::UPPER };
+    table_->store(hash, bestMove, scoreToTable(bestScore, ply), depth, bound);
+    return bestScore;
+}
+
+int Engine::quiesce(int alpha, int beta, int ply)
+{
+    ++nodes_;
+    pvLength_[ply] = ply;
+    if (checkStop())
+        return 0;
+
+    if (ply >= MAXPLY - 1)
+        return evaluate();
+
+    // 被将军时须应将, 否则以静态评估为下限只搜索吃子着法
+    bool inCheck { position_.isKilled(position_.sideColor()) };
+    int bestScore { -INFINITYSCORE };
+    if (!inCheck) {
+        bestScore = evaluate();
+        if (bestScore >= beta)
+            return bestScore;
+
+        alpha = qMax(alpha, bestScore);
+    }
+
+    MoveList moveList;
+    generateMoves(moveList, inCheck ? MoveStage::ALL : MoveStage::CAPTURE, 0, ply);
+    if (inCheck && moveList.isEmpty())
+        return -MATESCORE + ply;
+
+    for (PackedMove move : moveList) {
+        int fromIndex { MoveList::fromIndex(move) }, toIndex { MoveList::toIndex(move) };
+        plyMoves_[ply] = move;
+        int eatPieceIndex { position_.movePiece(fromIndex, toIndex) };
+        int score { -quiesce(-beta, -alpha, ply + 1) };
+        position_.undoMovePiece(fromIndex, toIndex, eatPieceIndex);
+        if (stopped())
+            return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+            if (score >= beta)
+                break;
+
+            alpha = qMax(alpha, score);
+        }
+    }
+
+    return bestScore;
+}
+
+void Engine::generateMoves(MoveList& moveList, MoveStage stage, PackedMove firstMove, int ply)
+{
+    position_.generateLegalMoves(position_.sideColor(), moveList, stage);
+    moveOrder_.sort(position_, moveList, ply, firstMove, ply > 0 ? plyMoves_[ply - 1] : PackedMove(0));
+}
+
+int Engine::evaluate() const
+{
+    return Evaluation::evaluate(position_, position_.sideColor());
+}
+
+bool Engine::hasNullMaterial(PieceColor color) const
+{
+    // 仅余兵(卒)与仕相时, 空着易误判(如困毙), 不做空着裁剪
+    for (PieceKind kind : { PieceKind::KNIGHT, PieceKind::ROOK, PieceKind::CANNON })
+        for (int pieceIndex = Position::firstPieceIndex(color, kind);
+             pieceIndex < Position::lastPieceIndex(color, kind); ++pieceIndex)
+            if (position_.seatIndex(pieceIndex) != Position::NOSEAT)
+                return true;
+
+    return false;
+}
+
+int Engine::scoreToTable(int score, int ply)
+{
+    return score > MATESCORE - MAXPLY ? score + ply
+        : score < MAXPLY - MATESCORE  ? score - ply
+                                      : score;
+}
+
+int Engine::scoreFromTable(int score, int ply)
+{
+    return score > MATESCORE - MAXPLY ? score - ply
+        : score < MAXPLY - MATESCORE  ? score + ply
+                                      : score;
+}
+
+bool Engine::checkStop()
+{
+    if ((limits_.nodes > 0 && nodes_ >= limits_.nodes)
+        || (limits_.msecs > 0 && (nodes_ & CHECKNODES) == 0 && timer_.elapsed() >= limits_.msecs))
+        *stop_ = true;
+
+    return stopped();
+}
@@ -0,0 +1,112 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+// 搜索引擎: 迭代加深的主要变例搜索(PVS), 含静态搜索、空着裁剪、后期着法减少(LMR)
+// 在局面核心的副本上搜索, 不改动Board, 可在界面之外单独运行
+// 置换表可由多个引擎共享(由调用方在每次搜索前调用newSearch), 未指定时引擎自建默认大小的置换表
+// 多线程搜索时各引擎另共享停止标志, 由主线程控制时间
+// 可设置对局至今的局面键历史, 搜索中重复局面按长将、长捉判负, 闲着循环判和
+
+#include "movelist.h"
+#include "moveorder.h"
+#include "position.h"
+#include "repetition.h"
+#include "transpositiontable.h"
+
+#include <QElapsedTimer>
+#include <QList>
+#include <atomic>
+#include <functional>
+
+// 搜索限制: 深度、时间(毫秒)、结点数, 0为不限
+struct SearchLimits {
+    int depth { 0 };
+    int msecs { 0 };
+    quint64 nodes { 0 };
+};
+
+// 搜索结果: 最佳着法、分值(走棋方视角)、完成的深度及主要变例
+// 未完成任何一次迭代时深度为0, 着法为第一个合法着法(无合法着法时为0)
+struct SearchResult {
+    PackedMove bestMove { 0 };
+    int score { 0 };
+    int depth { 0 };
+    QList<PackedMove> pv;
+    quint64 nodes { 0 };
+    qint64 msecs { 0 };
+    OrderStats orderStats;
+};
+
+// 每完成一次迭代时回调, 供界面、协议输出逐层的搜索信息
+using IterationCallback = std::function<void(const SearchResult&)>;
+
+class Engine {
+public:
+    static const int MAXPLY { 64 };
+    static const int INFINITYSCORE { 32000 };
+    static const int MATESCORE { 30000 };
+
+    explicit Engine(const Position& position, TranspositionTable* table = Q_NULLPTR,
+        std::atomic<bool>* stopFlag = Q_NULLPTR);
+    ~Engine();
+
+    Engine(const Engine&) = delete;
+    Engine& operator=(const Engine&) = delete;
+
+    SearchResult search(const SearchLimits& limits);
+    quint64 nodes() const { return nodes_; }
+    const OrderStats& orderStats() const { return moveOrder_.stats(); }
+
+    // 可由其他线程调用, 搜索尽快返回已完成深度的结果
+    void stop() { *stop_ = true; }
+
+    // 对局至今(不含当前局面)的局面键历史
+    void setHistory(const RepetitionHistory& history) { history_ = history; }
+
+    // 辅助线程序号: 奇数序号从深度2开始迭代(不超过限定深度), 使各线程搜索的深度错开
+    void setThreadIndex(int threadIndex) { startDepth_ = 1 + threadIndex % 2; }
+
+    void setIterationCallback(const IterationCallback& callback) { iterationCallback_ = callback; }
+
+    static bool isMateScore(int score) { return qAbs(score) > MATESCORE - MAXPLY; }
+
+private:
+    int search(int depth, int alpha, int beta, int ply, bool allowNull);
+    int quiesce(int alpha, int beta, int ply);
+
+    // 生成着法并排序, 上次迭代的主要变例着法或置换表着法最先
+    void generateMoves(MoveList& moveList, MoveStage stage, PackedMove firstMove, int ply);
+    int evaluate() const;
+    bool hasNullMaterial(PieceColor color) const;
+    bool checkStop();
+    bool stopped() const { return stop_->load(std::memory_order_relaxed); }
+
+    // 杀棋分值存入置换表时转换为相对当前结点的步数
+    static int scoreToTable(int score, int ply);
+    static int scoreFromTable(int score, int ply);
+
+    Position position_;
+    TranspositionTable* table_;
+    bool ownTable_;
+    SearchLimits limits_ {};
+    QElapsedTimer timer_;
+    std::atomic<bool> ownStop_ { false };
+    std::atomic<bool>* stop_;
+    int startDepth_ { 1 };
+    quint64 nodes_ { 0 };
+
+    RepetitionHistory history_;
+    IterationCallback iterationCallback_;
+
+    // 着法排序表, 及各层所走着法(空着为0)
+    MoveOrder moveOrder_;
+    PackedMove plyMoves_[MAXPLY];
+
+    // 三角形主要变例表, 及上次迭代的主要变例
+    PackedMove pvTable_[MAXPLY][MAXPLY];
+    int pvLength_[MAXPLY];
+    PackedMove prevPv_[MAXPLY];
+    int prevPvLength_ { 0 };
+    bool followPv_ { false };
+};
+
+#endif // ENGINE_H
@@ -0,0 +1,43 @@
+#include "evaluation.h"
+#include "piece.h"
+#include "position.h"
+#include "seatbase.h"
+#include "seattable.h"
+
+// 帅(将)安全: 过河攻子的权重(按PieceKind顺序), 及每缺一个仕相的扣分倍数
+static const int ATTACKWEIGHTS[] { 0, 0, 0, 2, 3, 2, 0 };
+static const int KINGSAFETYWEIGHT { 4 };
+static const int DEFENDERNUM { 4 };
+
+int Evaluation::evaluate(const Position& position, PieceColor color)
+{
+    PieceColor otherColor { PieceColor((int(color) + 1) % 2) };
+    return position.value(color) - position.value(otherColor)
+        - kingSafetyPenalty(position, color) + kingSafetyPenalty(position, otherColor);
+}
+
+int Evaluation::kingSafetyPenalty(const Position& position, PieceColor color)
+{
+    PieceColor otherColor { PieceColor((int(color) + 1) % 2) };
+    bool isBottom { position.getHomeSide(color) == SeatSide::BOTTOM };
+    int attack { 0 };
+    for (PieceKind kind : { PieceKind::KNIGHT, PieceKind::ROOK, PieceKind::CANNON })
+        for (int pieceIndex = Position::firstPieceIndex(otherColor, kind);
+             pieceIndex < Position::lastPieceIndex(otherColor, kind); ++pieceIndex) {
+            int index { position.seatIndex(pieceIndex) };
+            // 位于己方半边即为过河
+            if (index != Position::NOSEAT && (index / SeatTable::COLNUM < 5) == isBottom)
+                attack += ATTACKWEIGHTS[int(kind)];
+        }
+    if (attack == 0)
+        return 0;
+
+    int defender { 0 };
+    for (PieceKind kind : { PieceKind::ADVISOR, PieceKind::BISHOP })
+        for (int pieceIndex = Position::firstPieceIndex(color, kind);
+             pieceIndex < Position::lastPieceIndex(color, kind); ++pieceIndex)
+            if (position.seatIndex(pieceIndex) != Position::NOSEAT)
+                ++defender;
+
+    return attack * (DEFENDERNUM + 1 - defender) * KINGSAFETYWEIGHT;
+}
@@ -0,0 +1,93 @@
+#ifndef EVALUATION_H
+#define EVALUATION_H
+// 局面静态评价: 子力、位置分(由Position随走子增量维护)与帅(将)安全
+// 位置分表以己方底线为第0行, 左右对称; 顶方棋子按中心对称位置查表
+
+#include <QtGlobal>
+
+class Position;
+enum class PieceColor;
+enum class PieceKind;
+
+namespace Evaluation {
+
+// 棋子价值(按PieceKind顺序)
+inline constexpr int KINDVALUES[] { 0, 200, 200, 400, 900, 450, 100 };
+
+// 各种类棋子的位置分(按PieceKind顺序, 每表10行9列)
+inline constexpr qint16 PIECESQUARES[][90] {
+    // 帅(将)
+    { 0, 0, 0, -5, 0, -5, 0, 0, 0,
+        0, 0, 0, -15, -10, -15, 0, 0, 0,
+        0, 0, 0, -30, -25, -30, 0, 0, 0 },
+    // 仕(士)
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 5, 0, 0, 0, 0,
+        0, 0, 0, -5, 0, -5, 0, 0, 0 },
+    // 相(象)
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0,
+        -5, 0, 0, 0, 5, 0, 0, 0, -5,
+        0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, -5, 0, 0, 0, -5, 0, 0 },
+    // 马
+    { -10, -20, -10, -10, -10, -10, -10, -20, -10,
+        -10, -5, 0, 0, -20, 0, 0, -5, -10,
+        -5, 0, 10, 10, 5, 10, 10, 0, -5,
+        0, 5, 10, 15, 10, 15, 10, 5, 0,
+        0, 10, 20, 20, 20, 20, 20, 10, 0,
+        0, 15, 25, 25, 25, 25, 25, 15, 0,
+        5, 20, 30, 35, 30, 35, 30, 20, 5,
+        5, 20, 30, 40, 35, 40, 30, 20, 5,
+        0, 15, 25, 30, 25, 30, 25, 15, 0,
+        -5, 0, 5, 10, 0, 10, 5, 0, -5 },
+    // 车
+    { -10, 5, 0, 10, 0, 10, 0, 5, -10,
+        0, 5, 5, 10, 0, 10, 5, 5, 0,
+        0, 5, 5, 10, 10, 10, 5, 5, 0,
+        5, 10, 10, 15, 15, 15, 10, 10, 5,
+        10, 15, 15, 20, 20, 20, 15, 15, 10,
+        10, 15, 15, 20, 20, 20, 15, 15, 10,
+        10, 15, 15, 20, 25, 20, 15, 15, 10,
+        10, 20, 20, 25, 25, 25, 20, 20, 10,
+        15, 25, 20, 30, 30, 30, 20, 25, 15,
+        10, 15, 15, 20, 20, 20, 15, 15, 10 },
+    // 炮
+    { 0, 0, 5, 10, 10, 10, 5, 0, 0,
+        0, 5, 5, 0, 0, 0, 5, 5, 0,
+        5, 5, 5, 5, 15, 5, 5, 5, 5,
+        0, 0, 0, 0, 5, 0, 0, 0, 0,
+        0, 0, 5, 0, 10, 0, 5, 0, 0,
+        0, 0, 0, 0, 10, 0, 0, 0, 0,
+        0, 0, 0, 0, 5, 0, 0, 0, 0,
+        5, 5, 0, -5, 0, -5, 0, 5, 5,
+        5, 5, 0, -5, -10, -5, 0, 5, 5,
+        10, 10, 0, -10, -15, -10, 0, 10, 10 },
+    // 兵(卒): 过河后大幅增值
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, -2, 0, 4, 0, -2, 0, 0,
+        2, 0, 8, 0, 8, 0, 8, 0, 2,
+        60, 70, 80, 90, 90, 90, 80, 70, 60,
+        70, 90, 110, 120, 130, 120, 110, 90, 70,
+        70, 90, 110, 130, 140, 130, 110, 90, 70,
+        70, 90, 110, 130, 140, 130, 110, 90, 70,
+        0, 20, 40, 60, 70, 60, 40, 20, 0 },
+};
+
+// 某种类棋子在己方视角位置序号上的价值(子力与位置分之和)
+constexpr int pieceSquareValue(PieceKind kind, int homeIndex)
+{
+    return KINDVALUES[int(kind)] + PIECESQUARES[int(kind)][homeIndex];
+}
+
+// 某方视角的局面评价: 增量维护的子力与位置分之差, 加帅(将)安全
+int evaluate(const Position& position, PieceColor color);
+
+// 帅(将)安全扣分: 对方车马炮过河越多、己方仕相越少, 扣分越多
+int kingSafetyPenalty(const Position& position, PieceColor color);
+
+};
+
+#endif // EVALUATION_H
@@ -0,0 +1,230 @@
+#include "fencodec.h"
+#include "piece.h"
+#include "seattable.h"
+
+static const int ROWNUM { SeatTable::ROWNUM };
+static const int COLNUM { SeatTable::COLNUM };
+static const int COLORNUM { 2 };
+static const int KINDNUM { 7 };
+static const int NOCODE { -1 };
+
+static constexpr char16_t NULLCHAR { u'_' }; // 与PieceBase::NULLCHAR一致
+static constexpr char16_t SPLITCHAR { u'/' };
+static constexpr char16_t ENDCHARS[] { u' ', u'_' };
+
+// 与PieceBase中的字符表一致
+static constexpr char CHARS[COLORNUM][KINDNUM + 1] { "KABNRCP", "kabnrcp" };
+static constexpr int MAXCOUNTS[KINDNUM] { 1, 2, 2, 2, 2, 2, 5 };
+
+// ASCII字符对应的棋子编码(颜色 * KINDNUM + 种类)
+struct CodeTable {
+    signed char codes[128];
+};
+
+static constexpr CodeTable makeCodeTable()
+{
+    CodeTable table {};
+    for (auto& code : table.codes)
+        code = NOCODE;
+    for (int color = 0; color < COLORNUM; ++color)
+        for (int kind = 0; kind < KINDNUM; ++kind)
+            table.codes[int(CHARS[color][kind])] = color * KINDNUM + kind;
+
+    return table;
+}
+
+static constexpr CodeTable CODETABLE { makeCodeTable() };
+
+// 各位置可置将帅、仕士、相象的掩码: 位序号为种类 * SIDENUM + 侧(0为下侧)
+static constexpr int placeBit(PieceKind kind, int side) { return 1 << (int(kind) * SeatTable::SIDENUM + side); }
+
+struct PlaceTable {
+    unsigned char masks[SeatTable::SEATNUM];
+};
+
+static constexpr PlaceTable makePlaceTable()
+{
+    PlaceTable table {};
+    for (int index = 0; index < SeatTable::SEATNUM; ++index) {
+        int row { index / COLNUM }, col { index % COLNUM }, side { row < ROWNUM / 2 ? 0 : 1 };
+        int mask { 0 };
+        if (SeatTable::isKingAdv(row, col)) {
+            mask |= placeBit(PieceKind::KING, side);
+            if ((col == 4) == (row == 1 || row == ROWNUM - 2))
+                mask |= placeBit(PieceKind::ADVISOR, side);
+        }
+        // 相眼: 底线、河沿的2、6列, 及中间一行的0、4、8列
+        bool midRow { row == 2 || row == ROWNUM - 3 };
+        if (SeatTable::isBishopRow(row) && (midRow ? col % 4 == 0 : col == 2 || col == 6))
+            mask |= placeBit(PieceKind::BISHOP, side);
+        table.masks[index] = mask;
+    }
+
+    return table;
+}
+
+static constexpr PlaceTable PLACETABLE { makePlaceTable() };
+
+static int pieceCode(QChar ch)
+{
+    char16_t unicode { ch.unicode() };
+    return unicode < 128 ? CODETABLE.codes[unicode] : NOCODE;
+}
+
+static bool isEndChar(QChar ch)
+{
+    for (char16_t endChar : ENDCHARS)
+        if (ch.unicode() == endChar)
+            return true;
+
+    return false;
+}
+
+int FenCodec::encode(const QChar* pieChars, QChar* fen)
+{
+    int length { 0 };
+    for (int row = ROWNUM - 1; row >= 0; --row) {
+        int nullNum { 0 };
+        for (const QChar *ch = pieChars + row * COLNUM, *end = ch + COLNUM; ch != end; ++ch) {
+            if (ch->unicode() == NULLCHAR) {
+                ++nullNum;
+                continue;
+            }
+
+            if (nullNum != 0) {
+                fen[length++] = QChar(u'0' + nullNum);
+                nullNum = 0;
+            }
+            fen[length++] = *ch;
+        }
+        if (nullNum != 0)
+            fen[length++] = QChar(u'0' + nullNum);
+        if (row > 0)
+            fen[length++] = QChar(SPLITCHAR);
+    }
+
+    return length;
+}
+
+FenCodec::Error FenCodec::decode(const QChar* fen, int length, QChar* pieChars)
+{
+    int counts[COLORNUM][KINDNUM] {};
+    int kingSeats[COLORNUM] { SeatTable::NOINDEX, SeatTable::NOINDEX };
+    // 仕士、相象所在位置掩码之交, 待确定将帅所在一侧后校验
+    int advisorMasks[COLORNUM] { ~0, ~0 }, bishopMasks[COLORNUM] { ~0, ~0 };
+    int row { ROWNUM - 1 }, col { 0 };
+    for (const QChar *ch = fen, *end = fen + length; ch != end && !isEndChar(*ch); ++ch) {
+        if (ch->unicode() == SPLITCHAR) {
+            if (col != COLNUM)
+                return Error::ROWLENGTH;
+            if (row == 0)
+                return Error::ROWCOUNT;
+
+            --row;
+            col = 0;
+        } else if (ch->unicode() > u'0' && ch->unicode() <= u'0' + COLNUM) {
+            int nullNum { ch->unicode() - u'0' };
+            if (col + nullNum > COLNUM)
+                return Error::ROWLENGTH;
+
+            for (QChar *seatCh = pieChars + row * COLNUM + col, *seatEnd = seatCh + nullNum;
+                 seatCh != seatEnd; ++seatCh)
+                *seatCh = QChar(NULLCHAR);
+            col += nullNum;
+        } else {
+            int code { pieceCode(*ch) };
+            if (code == NOCODE)
+                return Error::PIECECHAR;
+            if (col == COLNUM)
+                return Error::ROWLENGTH;
+
+            int color { code / KINDNUM }, kind { code % KINDNUM }, seat { row * COLNUM + col++ };
+            if (++counts[color][kind] > MAXCOUNTS[kind])
+                return Error::PIECECOUNT;
+
+            if (kind == int(PieceKind::KING))
+                kingSeats[color] = seat;
+            else if (kind == int(PieceKind::ADVISOR))
+                advisorMasks[color] &= PLACETABLE.masks[seat];
+            else if (kind == int(PieceKind::BISHOP))
+                bishopMasks[color] &= PLACETABLE.masks[seat];
+            pieChars[seat] = *ch;
+        }
+    }
+    if (row != 0)
+        return Error::ROWCOUNT;
+    if (col != COLNUM)
+        return Error::ROWLENGTH;
+
+    int kingSides[COLORNUM] {};
+    for (int color = 0; color < COLORNUM; ++color) {
+        int kingSeat { kingSeats[color] };
+        if (kingSeat == SeatTable::NOINDEX)
+            return Error::PIECECOUNT;
+
+        int side { kingSeat / COLNUM < ROWNUM / 2 ? 0 : 1 };
+        if (!(PLACETABLE.masks[kingSeat] & placeBit(PieceKind::KING, side)))
+            return Error::KINGSEAT;
+        if (!(advisorMasks[color] & placeBit(PieceKind::ADVISOR, side)))
+            return Error::ADVISORSEAT;
+        if (!(bishopMasks[color] & placeBit(PieceKind::BISHOP, side)))
+            return Error::BISHOPSEAT;
+
+        kingSides[color] = side;
+    }
+
+    return kingSides[0] != kingSides[1] ? Error::NONE : Error::KINGSEAT;
+}
+
+int FenCodec::decodeBatch(const QString* fens, int count, QChar* pieChars, Error* errors)
+{
+    int validCount { 0 };
+    for (int index = 0; index < count; ++index, pieChars += SEATNUM) {
+        Error error { decode(fens[index].constData(), fens[index].size(), pieChars) };
+        if (error == Error::NONE)
+            ++validCount;
+        if (errors)
+            errors[index] = error;
+    }
+
+    return validCount;
+}
+
+bool FenCodec::colorKind(QChar ch, PieceColor& color, PieceKind& kind)
+{
+    int code { pieceCode(ch) };
+    if (code == NOCODE)
+        return false;
+
+    color = PieceColor(code / KINDNUM);
+    kind = PieceKind(code % KINDNUM);
+    return true;
+}
+
+const char* FenCodec::errorString(Error error)
+{
+    static const char* const strings[] {
+        "无错误", "行数不为10", "列数不为9", "无效字符", "棋子数量不符",
+        "将帅位置不符", "仕士位置不符", "相象位置不符"
+    };
+
+    return strings[int(error)];
+}
+
+QString FenCodec::toFEN(const QString& pieChars)
+{
+    if (pieChars.size() != SEATNUM)
+        return QString();
+
+    QChar fen[MAXLENGTH];
+    return QString(fen, encode(pieChars.constData(), fen));
+}
+
+QString FenCodec::toPieChars(const QString& fen)
+{
+    QChar pieChars[SEATNUM];
+    if (decode(fen.constData(), fen.size(), pieChars) != Error::NONE)
+        return QString();
+
+    return QString(pieChars, SEATNUM);
+}
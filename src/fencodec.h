@@ -0,0 +1,50 @@
+#ifndef FENCODEC_H
+#define FENCODEC_H
+// FEN棋子字段编解码: 字符均查编译期常量表, 结果写入调用方提供的定长缓冲区, 单个局面的转换不分配堆内存.
+// 棋子字符数组按位置序号(行0在下)排列, 空位为PieceBase::NULLCHAR; FEN自最上一行起, 以'/'分行.
+// 解码在同一遍扫描中校验行列数、棋子字符、各种棋子数量, 以及将帅、仕士、相象是否处于本方的可置子位置.
+
+#include <QChar>
+#include <QString>
+
+enum class PieceColor;
+enum class PieceKind;
+
+namespace FenCodec {
+
+constexpr int SEATNUM { 90 };
+constexpr int MAXLENGTH { SEATNUM + 9 }; // 每行至多9个字符, 另有9个分行符
+
+enum class Error {
+    NONE,
+    ROWCOUNT, // 行数不为10
+    ROWLENGTH, // 某行列数不为9
+    PIECECHAR, // 无效字符
+    PIECECOUNT, // 棋子数量超限, 或缺将帅
+    KINGSEAT, // 将帅不在九宫, 或双方同在一侧
+    ADVISORSEAT, // 仕士不在本方九宫斜线
+    BISHOPSEAT // 相象不在本方相眼
+};
+
+// 棋子字符数组(SEATNUM个)编码为FEN, 写入fen(至少MAXLENGTH个字符), 返回长度
+int encode(const QChar* pieChars, QChar* fen);
+
+// FEN解码为棋子字符数组, 写入pieChars(SEATNUM个); 遇空格或'_'(局面库键的分隔符)即止.
+// 返回Error::NONE以外的值时, pieChars内容不确定
+Error decode(const QChar* fen, int length, QChar* pieChars);
+
+// 批量解码: fens[i]写入pieChars + i * SEATNUM, 结果写入errors[i](可为空指针), 返回合格局面数
+int decodeBatch(const QString* fens, int count, QChar* pieChars, Error* errors);
+
+// 棋子字符对应的颜色、种类, 非棋子字符时返回false
+bool colorKind(QChar ch, PieceColor& color, PieceKind& kind);
+
+const char* errorString(Error error);
+
+// 便利接口, 失败时返回空串
+QString toFEN(const QString& pieChars);
+QString toPieChars(const QString& fen);
+
+};
+
+#endif // FENCODEC_H
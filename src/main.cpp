@@ -1,13 +1,74 @@
+#include "annotator.h"
 #include "mainwindow.h"
+#include "manualIO.h"
+#include "ucciserver.h"
 
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+
+static int runUcci(const QString& threads)
+{
+    QTextStream in(stdin), out(stdout);
+    UcciServer server([&out](const QString& line) { out << line << Qt::endl; });
+    server.execute("setoption threads " + threads);
+    QString line;
+    while (in.readLineInto(&line))
+        if (!server.execute(line.trimmed()))
+            break;
+    return 0;
+}
+
+static int runAnnotate(const QString& dirName, const QString& outDirName, int depth, quint64 nodes, int threads)
+{
+    AnnotateLimits limits { depth, nodes };
+    if (limits.depth <= 0 && limits.nodes == 0)
+        limits.depth = AnnotateLimits {}.depth;
+
+    Annotator annotator(limits, threads);
+    annotator.annotateDir(dirName, outDirName.isEmpty() ? dirName + "_annotated" : outDirName, StoreType::PGN_ZH);
+    QTextStream(stdout) << annotator.stats().toString() << Qt::endl;
+    return 0;
+}
 
 int main(int argc, char* argv[])
 {
-    QApplication a(argc, argv);
-    a.setOrganizationName("person");
-    a.setApplicationName("studyChess");
+    QCoreApplication::setOrganizationName("person");
+    QCoreApplication::setApplicationName("studyChess");
+
+    // 无界面批注: --annotate 棋谱目录 [-o 输出目录] [-d 深度] [-n 结点数] [-j 线程数]
+    // 作为UCCI引擎运行: --ucci [-j 线程数], 可供本程序或其他界面加载
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption annotateOption("annotate", "批注目录中的全部棋谱(不显示界面)", "dir");
+    QCommandLineOption outputOption({ "o", "output" }, "批注结果目录(默认为原目录名加_annotated)", "dir");
+    QCommandLineOption depthOption({ "d", "depth" }, "每个局面的搜索深度(默认8, 0为不限)", "depth", "8");
+    QCommandLineOption nodesOption({ "n", "nodes" }, "每个局面的搜索结点数(默认不限)", "nodes", "0");
+    QCommandLineOption threadsOption({ "j", "threads" }, "线程数(默认为处理器核数)", "threads",
+        QString::number(SearchThreads::idealThreadCount()));
+    QCommandLineOption ucciOption("ucci", "作为UCCI引擎运行(不显示界面)");
+    parser.addOptions({ annotateOption, outputOption, depthOption, nodesOption, threadsOption, ucciOption });
+
+    // 先解析参数, 无界面的运行方式不创建QApplication(不需要图形环境)
+    QStringList arguments;
+    for (int i = 0; i < argc; ++i)
+        arguments.append(QString::fromLocal8Bit(argv[i]));
+    parser.parse(arguments);
 
+    if (parser.isSet(ucciOption) || parser.isSet(annotateOption)) {
+        QCoreApplication a(argc, argv);
+        parser.process(a);
+        if (parser.isSet(ucciOption))
+            return runUcci(parser.value(threadsOption));
+
+        return runAnnotate(parser.value(annotateOption),
+            parser.isSet(outputOption) ? parser.value(outputOption) : QString(),
+            parser.value(depthOption).toInt(), parser.value(nodesOption).toULongLong(),
+            parser.value(threadsOption).toInt());
+    }
+
+    QApplication a(argc, argv);
+    parser.process(a);
     MainWindow w;
     w.show();
     return a.exec();
@@ -1,14 +1,19 @@
 #include "mainwindow.h"
+#include "board.h"
 #include "common.h"
 #include "database.h"
+#include "manual.h"
 #include "manualIO.h"
+#include "manualmove.h"
 #include "manualsubwindow.h"
+#include "matesolver.h"
 #include "piece.h"
 #include "test.h"
 #include "tools.h"
 #include "ui_mainwindow.h"
 #include <QFileDialog>
 #include <QMessageBox>
+#include <QtConcurrent>
 
 enum {
     FileTree_Name,
@@ -25,9 +30,11 @@ MainWindow::MainWindow(QWidget* parent)
     , fileModel(Q_NULLPTR)
     , insItemSelModel(Q_NULLPTR)
     , dataBase(new DataBase)
+    , mateVerifyWatcher(new QFutureWatcher<QString>(this))
     , ui(new Ui::MainWindow)
 {
     ui->setupUi(this);
+    connect(mateVerifyWatcher, &QFutureWatcherBase::finished, this, &MainWindow::mateVerifyFinished);
     initMenu();
 
     readSettings();
@@ -63,6 +70,9 @@ void MainWindow::on_actTest_triggered()
     TestBoard tboard;
     QTest::qExec(&tboard);
 
+    TestEngine tengine;
+    QTest::qExec(&tengine);
+
     TestManual tins;
     QTest::qExec(&tins);
 
@@ -73,6 +83,65 @@ void MainWindow::on_actTest_triggered()
     QTest::qExec(&tecco); // , { "-o output/testOutput.txt txt" }
 }
 
+// 逐个求解文件夹内残局类型的棋谱(自首着局面, 走棋方为首着方), 报告写入该文件夹, 返回吞吐量汇总
+static QString verifyMateDir(const QString& dirName)
+{
+    QStringList lines;
+    int count { 0 }, provenCount { 0 };
+    quint64 nodes { 0 };
+    qint64 msecs { 0 };
+    std::function<void(const QString&, void*)> solveFile__
+        = [&](const QString& fileName, void*) {
+              Manual manual;
+              if (!manual.read(fileName) || manual.getInfoValue(InfoIndex::TYPE) != "残局")
+                  return;
+
+              Position position { manual.board()->position() };
+              position.setSideColor(manual.manualMove()->firstColor());
+              MateSolver solver(position);
+              MateResult result { solver.solve() };
+              ++count;
+              provenCount += result.status == MateResult::PROVEN;
+              nodes += result.nodes;
+              msecs += result.msecs;
+              lines.append(QString("%1\t%2").arg(fileName).arg(result.toString()));
+          };
+
+    Tools::operateDir(dirName, solveFile__, nullptr, true);
+
+    QString summary { QString("残局: %1, 解出: %2, 结点: %3 (%4/秒), 用时: %5毫秒")
+                          .arg(count)
+                          .arg(provenCount)
+                          .arg(nodes)
+                          .arg(nodes * 1000 / qMax(msecs, qint64(1)))
+                          .arg(msecs) };
+    lines.append(summary);
+    Tools::writeTxtFile(dirName + "/mate_report.txt", lines.join('\n'), QIODevice::WriteOnly);
+    return summary;
+}
+
+void MainWindow::on_actMateVerify_triggered()
+{
+    if (mateVerifyWatcher->isRunning())
+        return;
+
+    QString dirName { QFileDialog::getExistingDirectory(this, "批量解杀: 选择残局棋谱文件夹") };
+    if (dirName.isEmpty())
+        return;
+
+    // 每题至多达到解杀的结点与内存限制, 整批可能耗时很长, 在后台线程求解
+    ui->actMateVerify->setEnabled(false);
+    statusBar()->showMessage(QString("批量解杀进行中: %1").arg(dirName));
+    mateVerifyWatcher->setFuture(QtConcurrent::run(verifyMateDir, dirName));
+}
+
+void MainWindow::mateVerifyFinished()
+{
+    ui->actMateVerify->setEnabled(true);
+    statusBar()->clearMessage();
+    Tools::messageBox("批量解杀", mateVerifyWatcher->result() + "\n", "关闭");
+}
+
 void MainWindow::on_actNew_triggered()
 {
     ManualSubWindow* manualSubWindow = createManualSubWindow();
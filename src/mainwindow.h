@@ -2,6 +2,7 @@
 #define MAINWINDOW_H
 
 #include <QFileSystemModel>
+#include <QFutureWatcher>
 #include <QItemSelectionModel>
 #include <QMainWindow>
 #include <QMdiSubWindow>
@@ -34,6 +35,8 @@ protected:
 
 private slots:
     void on_actTest_triggered();
+    void on_actMateVerify_triggered();
+    void mateVerifyFinished();
 
     // 文件菜单
     void on_actNew_triggered();
@@ -115,6 +118,8 @@ private:
     QFileSystemModel* fileModel;
     QItemSelectionModel* insItemSelModel;
     DataBase* dataBase;
+    // 批量解杀在后台线程进行, 结果为汇总
+    QFutureWatcher<QString>* mateVerifyWatcher;
 
     Ui::MainWindow* ui;
 };
@@ -6,9 +6,11 @@
 #include "manualIO.h"
 #include "manualmove.h"
 #include "manualmoveiterator.h"
+#include "matesolver.h"
 #include "move.h"
 #include "piece.h"
 #include "piecebase.h"
+#include "position.h"
 #include "seat.h"
 #include "seatbase.h"
 #include "tools.h"
@@ -91,6 +93,28 @@ ManualMoveAppendIterator Manual::appendIter()
     return ManualMoveAppendIterator(manualMove_);
 }
 
+bool Manual::appendMateSolution(const MateResult& result)
+{
+    Move* curMove { manualMove_->move() };
+    if (result.status != MateResult::PROVEN || result.solution.isEmpty() || curMove->hasNext())
+        return false;
+
+    {
+        // 迭代器析构时回到首着并重算着法数值
+        ManualMoveAppendIterator iter { appendIter() };
+        for (int i = 0; i < result.solution.count(); ++i) {
+            const MateMove& mateMove { result.solution.at(i) };
+            CoordPair coordPair { SeatBase::getCoord(MoveList::fromIndex(mateMove.move)),
+                SeatBase::getCoord(MoveList::toIndex(mateMove.move)) };
+            iter.append_coordPair(coordPair, i == 0 ? result.statusString() : QString(),
+                mateMove.hasNext, mateMove.hasOther);
+        }
+    }
+    manualMove_->goTo(curMove);
+
+    return true;
+}
+
 bool Manual::changeLayout(ChangeType ct)
 {
     Move* curMove { manualMove_->move() };
@@ -120,7 +144,34 @@ void Manual::setInfoValue(InfoIndex nameIndex, const QString& value)
     info_[ManualIO::getInfoName(nameIndex)] = value;
 }
 
+QString Manual::getGameResult(GameState state, PieceColor sideColor)
+{
+    if (state == GameState::ONGOING)
+        return {};
+
+    return sideColor == PieceColor::RED ? "黑胜" : "红胜";
+}
+
+GameState Manual::setGameResult()
+{
+    GameState state { board_->gameState() };
+    if (state != GameState::ONGOING)
+        setInfoValue(InfoIndex::RESULT, getGameResult(state, board_->position().sideColor()));
+
+    return state;
+}
+
 QString Manual::getECCORowcols() const
+{
+    QList<CoordPair> coordPairs;
+    ManualMoveOnlyNextIterator onlyNextIter(manualMove_);
+    while (onlyNextIter.hasNext())
+        coordPairs.append(onlyNextIter.next()->coordPair());
+
+    return getECCORowcols(coordPairs);
+}
+
+QString Manual::getECCORowcols(const QList<CoordPair>& coordPairs)
 {
     std::function<QString(CoordPair&, ChangeType)>
         getChangeRowcol_ = [](CoordPair& seatCoordPair, ChangeType ct) -> QString {
@@ -137,13 +188,9 @@ QString Manual::getECCORowcols() const
     int color = 0;
     QString rowcol[4][PieceBase::ALLCOLORS.size()];
 
-    ManualMoveOnlyNextIterator onlyNextIter(manualMove_);
-    while (onlyNextIter.hasNext()) {
-        Move* move = onlyNextIter.next();
-
-        rowcol[0][color].append(move->rowcols());
+    for (CoordPair coordPair : coordPairs) {
+        rowcol[0][color].append(getChangeRowcol_(coordPair, ChangeType::NOCHANGE));
         int chIndex = 1;
-        CoordPair coordPair = move->coordPair();
         for (ChangeType ct : { ChangeType::SYMMETRY_H, ChangeType::ROTATE, ChangeType::SYMMETRY_H })
             rowcol[chIndex++][color].append(getChangeRowcol_(coordPair, ct));
 
@@ -167,10 +214,14 @@ void Manual::setFEN(const QString& fen, PieceColor color)
     info_["FEN"] = QString("%1 %2 - - 0 1").arg(fen).arg((color == PieceColor::RED ? "r" : "b"));
 }
 
-void Manual::setBoard()
+bool Manual::setBoard()
 {
-    const QString& fen = info_["FEN"];
-    board_->setFEN(fen.left(fen.indexOf(' ')));
+    // 未记录FEN时为初始局面; FEN不合格时返回false, 由读取过程报告失败
+    QString fen = info_.value("FEN");
+    if (fen.isEmpty())
+        fen = PieceBase::FENSTR + " r - - 0 1";
+    return board_->setFEN(fen.left(fen.indexOf(' ')),
+        fen.section(' ', 1, 1) == "b" ? PieceColor::BLACK : PieceColor::RED);
 }
 
 SeatSide Manual::getHomeSide(PieceColor color) const
@@ -227,7 +278,9 @@ QList<Aspect> Manual::getAspectList()
     ManualMoveFirstNextIterator firstNextIter(manualMove_);
     while (firstNextIter.hasNext()) {
         Move* move = firstNextIter.next();
-        aspectList.append(Aspect(board_->getFEN(), move->color(), move->rowcols()));
+        Aspect aspect(board_->getFEN(), move->color(), move->rowcols());
+        aspect.evaluate[Evaluate::Value] = board_->getMoveValue(move->seatPair());
+        aspectList.append(aspect);
     }
 
     return aspectList;
@@ -24,10 +24,13 @@ class Move;
 using InfoMap = QMap<QString, QString>;
 enum class InfoIndex;
 enum class StoreType;
+enum class GameState;
 
 class ManualMove;
 class ManualMoveAppendIterator;
 
+struct MateResult;
+
 class Aspect;
 using PAspect = Aspect *;
 
@@ -54,6 +57,8 @@ public:
   Board *board() const { return board_; };
   ManualMove *manualMove() const { return manualMove_; }
   ManualMoveAppendIterator appendIter();
+  // 在当前着法之后追加杀局解答树, 当前着法已有后着或未证明时不追加
+  bool appendMateSolution(const MateResult &result);
 
   bool changeLayout(ChangeType ct);
 
@@ -63,11 +68,18 @@ public:
   QString getInfoValue(InfoIndex nameIndex);
   void setInfoValue(InfoIndex nameIndex, const QString &value);
 
+  // 走棋方被杀或困毙时的对局结果(对方胜), 对局未结束时为空
+  static QString getGameResult(GameState state, PieceColor sideColor);
+  // 按当前局面判定对局状态, 已分胜负时记入结果信息
+  GameState setGameResult();
+
   QString getECCORowcols() const;
+  // 由主线着法的起止坐标生成ECCO行列串(含左右对称、旋转等四种变换)
+  static QString getECCORowcols(const QList<CoordPair> &coordPairs);
   void setEcco(const QStringList &eccoRec);
 
   void setFEN(const QString &fen, PieceColor color);
-  void setBoard();
+  bool setBoard();
 
   SeatSide getHomeSide(PieceColor color) const;
   QString getPieceChars() const;
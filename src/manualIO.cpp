@@ -174,7 +174,7 @@ ManualIO* ManualIO::getManualIO_(const QString& fileName)
     return getManualIO_(index < 0 ? StoreType::NOTSTORETYPE : StoreType(index));
 }
 
-void ManualIO::readInfo_(Manual* manual, QTextStream& stream)
+bool ManualIO::readInfo_(Manual* manual, QTextStream& stream)
 {
     QString qstr {}, line {};
     while (!(line = stream.readLine()).isEmpty()) // 以空行为终止特征
@@ -189,7 +189,7 @@ void ManualIO::readInfo_(Manual* manual, QTextStream& stream)
         infoMap[match.captured(1)] = match.captured(2);
     }
 
-    manual->setBoard();
+    return manual->setBoard();
 }
 
 void ManualIO::writeInfo_(const Manual* manual, QTextStream& stream)
@@ -377,7 +377,8 @@ bool ManualIO_xqf::read_(Manual* manual, QFile& file)
 
     file.seek(1024);
     manual->manualMove()->setCurRemark(__readDataAndGetRemark());
-    manual->setBoard();
+    if (!manual->setBoard())
+        return false;
     ManualMoveAppendIterator appendIter { manual->appendIter() };
     if (tag & 0x80) //# 有左子树
         while (stream.status() == QDataStream::Status::Ok && !appendIter.isEnd()) {
@@ -431,7 +432,8 @@ bool ManualIO_bin::read_(Manual* manual, QFile& file)
             stream >> key >> infoMap[key];
         }
     }
-    manual->setBoard();
+    if (!manual->setBoard())
+        return false;
 
     QString remark;
     stream >> remark;
@@ -489,7 +491,8 @@ bool ManualIO_json::read_(Manual* manual, QFile& file)
     InfoMap& infoMap = manual->getInfoMap();
     for (auto iter = jsonInfo.constBegin(); iter != jsonInfo.constEnd(); ++iter)
         infoMap[iter.key()] = iter.value().toString();
-    manual->setBoard();
+    if (!manual->setBoard())
+        return false;
 
     //    std::function<void(bool, QJsonObject)>
     //        __readMove = [&](bool isOther, QJsonObject item) {
@@ -741,7 +744,9 @@ bool ManualIO_pgn::writeMove_pgn_iccszh_(const Manual* manual,
 
 bool ManualIO_pgn::read_(Manual* manual, QTextStream& stream)
 {
-    readInfo_(manual, stream);
+    if (!readInfo_(manual, stream))
+        return false;
+
     readMove_(manual, stream);
 
     return true;
@@ -63,7 +63,7 @@ protected:
     ManualIO() = default; // 允许子类创建实例
     virtual ~ManualIO() = default;
 
-    static void readInfo_(Manual* manual, QTextStream& stream);
+    static bool readInfo_(Manual* manual, QTextStream& stream);
     static void writeInfo_(const Manual* manual, QTextStream& stream);
 
     virtual void readMove_(Manual* /*manual*/, QTextStream& /*stream*/) { }
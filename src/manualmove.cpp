@@ -2,6 +2,7 @@
 #include "board.h"
 #include "manualmoveiterator.h"
 #include "move.h"
+#include "movelist.h"
 #include "piece.h"
 #include "piecebase.h"
 #include "seat.h"
@@ -83,7 +84,7 @@ bool ManualMove::goNext() {
     return false;
 
   curMove_ = curMove_->nextMove();
-  curMove_->done();
+  doneMove(curMove_);
   return true;
 }
 
@@ -91,7 +92,7 @@ bool ManualMove::backNext() {
   if (!curMove_->isNext())
     return false;
 
-  curMove_->undo();
+  undoMove(curMove_);
   curMove_ = curMove_->preMove();
   return true;
 }
@@ -100,9 +101,9 @@ bool ManualMove::goOther() {
   if (!curMove_->hasOther())
     return false;
 
-  curMove_->undo();
+  undoMove(curMove_);
   curMove_ = curMove_->otherMove();
-  curMove_->done();
+  doneMove(curMove_);
   return true;
 }
 
@@ -110,9 +111,9 @@ bool ManualMove::backOther() {
   if (!curMove_->isOther())
     return false;
 
-  curMove_->undo(); // 变着回退
+  undoMove(curMove_); // 变着回退
   curMove_ = curMove_->preMove();
-  curMove_->done(); // 前变执行
+  doneMove(curMove_); // 前变执行
   return true;
 }
 
@@ -162,7 +163,7 @@ bool ManualMove::goTo(Move *move) {
 
   backStart();
   for (auto &move : move->getPrevMoves())
-    move->done();
+    doneMove(move);
 
   curMove_ = move;
   return true;
@@ -218,6 +219,25 @@ QString ManualMove::moveInfo() const {
 
 QString ManualMove::curZhStr() const { return curMove_->zhStr(); }
 
+Repetition ManualMove::curRepetition() const {
+  return repetitionHistory_.check(board_->position());
+}
+
+void ManualMove::doneMove(Move *move) {
+  SeatPair seatPair{move->seatPair()};
+  quint64 hash{board_->hash()};
+  bool isCapture{seatPair.second->hasPiece()};
+  move->done();
+  repetitionHistory_.push(
+      hash, MoveList::pack(seatPair.first->index(), seatPair.second->index()),
+      isCapture);
+}
+
+void ManualMove::undoMove(Move *move) {
+  repetitionHistory_.pop();
+  move->undo();
+}
+
 Move *ManualMove::append_seatPair(SeatPair seatPair, const QString &remark,
                                   QString zhStr) {
   bool isOther{true};
@@ -1,6 +1,7 @@
 #ifndef MANUALMOVE_H
 #define MANUALMOVE_H
 
+#include "repetition.h"
 #include <QList>
 
 //#define DEBUG
@@ -72,13 +73,22 @@ public:
     QString moveInfo() const;
     QString curZhStr() const;
 
+    // 当前着法路径(根至当前着)的局面键历史, 及当前局面的重复判别
+    const RepetitionHistory& repetitionHistory() const { return repetitionHistory_; }
+    Repetition curRepetition() const;
+
 private:
+    // 执行、撤销着法, 同步压入、弹出局面键历史
+    void doneMove(Move* move);
+    void undoMove(Move* move);
+
     Move* append_seatPair(SeatPair seatPair, const QString& remark, QString zhStr = "");
     bool curColorIs(PieceColor color) const;
 
     const Board* board_;
     Move* rootMove_;
     Move* curMove_;
+    RepetitionHistory repetitionHistory_;
 
     int movCount_ { 0 };
     int remCount_ { 0 };
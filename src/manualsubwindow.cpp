@@ -1,15 +1,22 @@
 #include "manualsubwindow.h"
 #include "boardscene.h"
+#include "board.h"
 #include "boardview.h"
 #include "command.h"
 #include "common.h"
 #include "manual.h"
 #include "manualIO.h"
 #include "manualmove.h"
+#include "matesolver.h"
 #include "move.h"
 #include "moveitem.h"
 #include "moveview.h"
+#include "position.h"
+#include "searchthreads.h"
+#include "seatbase.h"
+#include "tablebase.h"
 #include "tools.h"
+#include "ucciclient.h"
 #include "ui_manualsubwindow.h"
 
 #include <QActionGroup>
@@ -24,8 +31,10 @@
 //#include <QSound>
 #include <QSoundEffect>
 #include <QTimer>
+#include <QtConcurrent>
 
 static const int MoveCount { 5 };
+static const int HINTMSECS { 1000 }; // 提示着法的搜索时间(毫秒)
 
 static const QStringList StateStrings { "布局", "打谱", "演示" };
 
@@ -37,9 +46,17 @@ ManualSubWindow::ManualSubWindow(QWidget* parent)
     , state_(SubWinState::NOTSTATE)
     , manual_(new Manual)
     , commandContainer_(new CommandContainer)
+    , ucciClient_(new UcciClient(this))
+    , hintTable_(Q_NULLPTR)
+    , hintWatcher_(new QFutureWatcher<SearchResult>(this))
+    , hintHash_(0)
+    , mateWatcher_(new QFutureWatcher<MateResult>(this))
+    , mateHash_(0)
     , ui(new Ui::ManualSubWindow)
 {
     ui->setupUi(this);
+    connect(hintWatcher_, &QFutureWatcherBase::finished, this, &ManualSubWindow::showHint);
+    connect(mateWatcher_, &QFutureWatcherBase::finished, this, &ManualSubWindow::showMateSolution);
     connect(this, &ManualSubWindow::manualMoveModified, this,
         &ManualSubWindow::manualModified);
     connect(this, &ManualSubWindow::manualMoveModified, this,
@@ -57,6 +74,24 @@ ManualSubWindow::ManualSubWindow(QWidget* parent)
     connect(this, &ManualSubWindow::manualMoveWalked, ui->moveView,
         &MoveView::updateSelectedNodeItem);
 
+    connect(this, &ManualSubWindow::manualMoveWalked, this,
+        &ManualSubWindow::updateAnalysis);
+
+    connect(ucciClient_, &UcciClient::ready, this, [this](const QString& engineName) {
+        ui->engineTextEdit->appendPlainText("引擎就绪: " + engineName);
+        updateAnalysis();
+    });
+    connect(ucciClient_, &UcciClient::infoReceived, this, [this](const UcciInfo& info) {
+        ui->engineTextEdit->appendPlainText(info.toString());
+    });
+    connect(ucciClient_, &UcciClient::bestMoveReceived, this,
+        [this](const QString& bestMove, const QString& zhBestMove) {
+            Q_UNUSED(bestMove)
+            ui->engineTextEdit->appendPlainText("最佳着法: " + zhBestMove);
+        });
+    connect(ucciClient_, &UcciClient::errorOccurred, ui->engineTextEdit,
+        &QPlainTextEdit::appendPlainText);
+
     connect(ui->moveView, &MoveView::mousePressed, this,
         &ManualSubWindow::on_curMoveChanged);
     connect(ui->moveView, &MoveView::wheelScrolled, this,
@@ -70,6 +105,10 @@ ManualSubWindow::ManualSubWindow(QWidget* parent)
 
 ManualSubWindow::~ManualSubWindow()
 {
+    // 后台搜索仍在使用置换表
+    hintWatcher_->waitForFinished();
+    mateWatcher_->waitForFinished();
+    delete hintTable_;
     delete commandContainer_;
     delete manual_;
     delete ui;
@@ -153,7 +192,26 @@ bool ManualSubWindow::appendMove(const CoordPair& coordPair)
     if (!canUseModifyCommand())
         return false;
 
-    return appendCommand(new AppendModifyCommand(manual_, coordPair));
+    if (!appendCommand(new AppendModifyCommand(manual_, coordPair)))
+        return false;
+
+    // 走子后局面重复, 提示判别结果
+    Repetition repetition { manual_->manualMove()->curRepetition() };
+    if (repetition.kind != RepetitionKind::NONE)
+        Tools::messageBox("局面重复", repetition.toString() + "。\n", "关闭");
+
+    // 对弈时走子后对方被杀或困毙, 记入结果并提示
+    if (isState(SubWinState::PLAY)) {
+        GameState state { manual_->setGameResult() };
+        if (state != GameState::ONGOING)
+            Tools::messageBox("对局结束",
+                QString("%1, %2。\n")
+                    .arg(state == GameState::CHECKMATE ? "绝杀" : "困毙")
+                    .arg(manual_->getInfoValue(InfoIndex::RESULT)),
+                "关闭");
+    }
+
+    return true;
 }
 
 QString ManualSubWindow::getFilter(bool isSave)
@@ -415,6 +473,9 @@ void ManualSubWindow::on_boardView_customContextMenuRequested(
     menu->addAction(ui->actGoEnd);
 
     menu->addSeparator();
+    menu->addAction(ui->actHint);
+    menu->addAction(ui->actMateSolve);
+    menu->addAction(ui->actAnalyze);
     menu->addMenu(ui->btnTurnState->menu());
 
     menu->addSeparator();
@@ -456,6 +517,8 @@ void ManualSubWindow::on_studyTabWidget_customContextMenuRequested(
     Q_UNUSED(pos)
     QMenu* menu = new QMenu(this);
     menu->addAction(ui->actStudy);
+    menu->addAction(ui->actLoadEngine);
+    menu->addAction(ui->actAnalyze);
     menu->exec(QCursor::pos());
     delete menu;
 }
@@ -670,6 +733,157 @@ void ManualSubWindow::on_actDeleteMove_triggered()
 
 void ManualSubWindow::on_actExportMove_triggered() { }
 
+void ManualSubWindow::on_actHint_triggered()
+{
+    if (!isState(SubWinState::PLAY)) {
+        Tools::messageBox("提示着法", "【提示】命令需要在【打谱】模式下执行。\n", "关闭");
+        return;
+    }
+
+    Board* board { manual_->board() };
+    // 残局库中有此局面时直接给出结果与最佳着法
+    static const Tablebases tablebases;
+    TablebaseResult tbResult { tablebases.probe(board->position()) };
+    PackedMove tbMove { tbResult.wdl == TablebaseResult::NONE ? PackedMove(0) : tablebases.probeMove(board->position()) };
+    if (tbMove) {
+        int fromIndex { MoveList::fromIndex(tbMove) }, toIndex { MoveList::toIndex(tbMove) };
+        SeatPair seatPair { board->getSeatPair({ SeatBase::getCoord(fromIndex), SeatBase::getCoord(toIndex) }) };
+        Tools::messageBox("提示着法",
+            QString("建议着法: %1\n\n残局库: %2\n")
+                .arg(board->getZhStr(seatPair))
+                .arg(tbResult.toString(board->position().sideColor())),
+            "关闭");
+        return;
+    }
+
+    if (hintWatcher_->isRunning())
+        return;
+
+    // 在局面副本上后台搜索, 不阻塞界面
+    if (!hintTable_)
+        hintTable_ = new TranspositionTable;
+    Position position { board->snapshot() };
+    RepetitionHistory history { manual_->manualMove()->repetitionHistory() };
+    TranspositionTable* table { hintTable_ };
+    hintHash_ = board->hash();
+    ui->actHint->setEnabled(false);
+    hintWatcher_->setFuture(QtConcurrent::run([position, history, table]() {
+        SearchThreads searchThreads(position, table, SearchThreads::idealThreadCount());
+        searchThreads.setHistory(history);
+        return searchThreads.search({ 0, HINTMSECS });
+    }));
+}
+
+void ManualSubWindow::showHint()
+{
+    ui->actHint->setEnabled(true);
+    Board* board { manual_->board() };
+    // 搜索期间已走子或改变局面, 结果作废
+    if (board->hash() != hintHash_)
+        return;
+
+    SearchResult result { hintWatcher_->result() };
+    if (!result.bestMove) {
+        Tools::messageBox("提示着法", "当前局面已无着法可走。\n", "关闭");
+        return;
+    }
+
+    int fromIndex { MoveList::fromIndex(result.bestMove) }, toIndex { MoveList::toIndex(result.bestMove) };
+    SeatPair seatPair { board->getSeatPair({ SeatBase::getCoord(fromIndex), SeatBase::getCoord(toIndex) }) };
+    QString scoreString { Engine::isMateScore(result.score)
+            ? QString(result.score > 0 ? "胜" : "负")
+            : QString::number(result.score) };
+    Tools::messageBox("提示着法",
+        QString("建议着法: %1\n\n评分: %2  深度: %3  结点: %4  用时: %5毫秒\n")
+            .arg(board->getZhStr(seatPair))
+            .arg(scoreString)
+            .arg(result.depth)
+            .arg(result.nodes)
+            .arg(result.msecs),
+        "关闭");
+}
+
+void ManualSubWindow::on_actMateSolve_triggered()
+{
+    if (!canUseModifyCommand()) {
+        Tools::messageBox("杀局解题", "【解杀】命令需要在【打谱】模式下执行。\n", "关闭");
+        return;
+    }
+
+    if (manual_->manualMove()->move()->hasNext()) {
+        Tools::messageBox("杀局解题", "当前着法之后已有着法, 请在末着处执行。\n", "关闭");
+        return;
+    }
+
+    if (mateWatcher_->isRunning())
+        return;
+
+    // 在局面副本上后台求解, 不阻塞界面: 先解连将杀, 不成再放开攻方全部着法
+    Position position { manual_->board()->snapshot() };
+    mateHash_ = manual_->board()->hash();
+    ui->actMateSolve->setEnabled(false);
+    mateWatcher_->setFuture(QtConcurrent::run([position]() {
+        MateResult result;
+        for (bool checksOnly : { true, false }) {
+            MateLimits limits;
+            limits.checksOnly = checksOnly;
+            MateSolver solver(position, limits);
+            result = solver.solve();
+            if (result.status == MateResult::PROVEN)
+                break;
+        }
+        return result;
+    }));
+}
+
+void ManualSubWindow::showMateSolution()
+{
+    ui->actMateSolve->setEnabled(true);
+    // 求解期间已走子或改变局面, 结果作废
+    if (manual_->board()->hash() != mateHash_)
+        return;
+
+    MateResult result { mateWatcher_->result() };
+    if (manual_->appendMateSolution(result))
+        emit manualMoveModified();
+    Tools::messageBox("杀局解题", result.toString() + "\n", "关闭");
+}
+
+void ManualSubWindow::on_actLoadEngine_triggered()
+{
+    QString fileName { QFileDialog::getOpenFileName(this, "加载UCCI引擎") };
+    if (fileName.isEmpty())
+        return;
+
+    ui->studyTabWidget->setCurrentWidget(ui->engineTab);
+    ui->engineTextEdit->appendPlainText("启动引擎: " + fileName);
+    ucciClient_->start(fileName);
+}
+
+void ManualSubWindow::on_actAnalyze_toggled(bool checked)
+{
+    if (!checked) {
+        ucciClient_->stopAnalyze();
+        return;
+    }
+
+    if (ucciClient_->state() == UcciClient::State::NOTSTARTED)
+        on_actLoadEngine_triggered();
+    updateAnalysis();
+}
+
+// 引擎未就绪时局面暂存, 就绪后即开始分析
+void ManualSubWindow::updateAnalysis()
+{
+    if (!ui->actAnalyze->isChecked())
+        return;
+
+    Board* board { manual_->board() };
+    ui->studyTabWidget->setCurrentWidget(ui->engineTab);
+    ui->engineTextEdit->clear();
+    ucciClient_->analyze(board->getFEN(), board->position().sideColor());
+}
+
 QMdiSubWindow* ManualSubWindow::getSubWindow() const
 {
     return qobject_cast<QMdiSubWindow*>(parent());
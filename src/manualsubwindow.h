@@ -1,6 +1,7 @@
 #ifndef MANUALSUBWINDOW_H
 #define MANUALSUBWINDOW_H
 
+#include <QFutureWatcher>
 #include <QGraphicsLineItem>
 #include <QGraphicsScene>
 #include <QMdiSubWindow>
@@ -21,6 +22,11 @@ class Command;
 class CommandContainer;
 enum class CommandType;
 
+class UcciClient;
+class TranspositionTable;
+struct SearchResult;
+struct MateResult;
+
 enum class SubWinState {
     LAYOUT,
     PLAY,
@@ -146,6 +152,19 @@ private slots:
     void on_actDeleteMove_triggered();
     void on_actExportMove_triggered();
 
+    // 打谱模式下搜索提示着法
+    void on_actHint_triggered();
+    void on_actMateSolve_triggered();
+    // 后台搜索完成, 局面未变时提示
+    void showHint();
+    // 后台解杀完成, 局面未变时追加解答
+    void showMateSolution();
+
+    // 外部UCCI引擎分析: 当前着法改变时重新分析
+    void on_actLoadEngine_triggered();
+    void on_actAnalyze_toggled(bool checked);
+    void updateAnalysis();
+
 private:
     QMdiSubWindow* getSubWindow() const;
 
@@ -182,6 +201,14 @@ private:
     SubWinState state_;
     Manual* manual_;
     CommandContainer* commandContainer_;
+    UcciClient* ucciClient_;
+    // 提示着法: 每窗口一个置换表(首次提示时分配), 后台搜索期间提示命令不可用
+    TranspositionTable* hintTable_;
+    QFutureWatcher<SearchResult>* hintWatcher_;
+    quint64 hintHash_;
+    // 解杀: 后台求解期间解杀命令不可用
+    QFutureWatcher<MateResult>* mateWatcher_;
+    quint64 mateHash_;
 
     Ui::ManualSubWindow* ui;
 };
@@ -0,0 +1,204 @@
+#include "matesolver.h"
+#include "piece.h"
+
+#include <QElapsedTimer>
+
+static const quint32 INFINITE { 0x3FFFFFFF };
+
+static quint32 addNumber(quint32 first, quint32 second)
+{
+    return qMin(first + second, INFINITE);
+}
+
+static PieceColor otherColor(PieceColor color)
+{
+    return PieceColor((int(color) + 1) % 2);
+}
+
+QString MateResult::statusString() const
+{
+    return status == PROVEN ? QString("%1步杀").arg((length + 1) / 2)
+        : status == DISPROVEN ? QString("无杀")
+                              : QString("未解出");
+}
+
+QString MateResult::toString() const
+{
+    return QString("%1, 结点: %2 (%3/秒), 内存: %4KB, 用时: %5毫秒")
+        .arg(statusString())
+        .arg(nodes)
+        .arg(nodes * 1000 / qMax(msecs, qint64(1)))
+        .arg(memory / 1024)
+        .arg(msecs);
+}
+
+MateSolver::MateSolver(const Position& position, const MateLimits& limits)
+    : position_(position)
+    , attackColor_(position.sideColor())
+    , limits_(limits)
+{
+}
+
+MateResult MateSolver::solve()
+{
+    QElapsedTimer timer;
+    timer.start();
+    table_.clear();
+    path_.clear();
+    nodes_ = 0;
+    isAborted_ = false;
+
+    mid(INFINITE, INFINITE, 0);
+
+    MateResult result;
+    Entry rootEntry { entry(position_.hash()) };
+    if (rootEntry.pn == 0) {
+        result.status = MateResult::PROVEN;
+        result.length = rootEntry.length;
+        extract(result.solution);
+    } else if (rootEntry.dn == 0)
+        result.status = MateResult::DISPROVEN;
+    result.nodes = nodes_;
+    result.msecs = timer.elapsed();
+    result.memory = qint64(table_.count()) * ENTRYBYTES;
+
+    return result;
+}
+
+void MateSolver::mid(quint32 thpn, quint32 thdn, int ply)
+{
+    ++nodes_;
+    if (isLimited())
+        return;
+
+    quint64 hash { position_.hash() };
+    MoveList moveList;
+    generateMoves(moveList);
+    bool isOr { isOrNode() };
+    if (moveList.isEmpty()) {
+        // 守方无着可走即被杀, 攻方无着(或无将军着法)则不成杀
+        table_[hash] = isOr ? Entry { INFINITE, 0, 0 } : Entry { 0, INFINITE, 0 };
+        return;
+    }
+
+    // 子结点的局面键, 当前路径上重复或超过最大深度者视为否证
+    quint64 childHashs[MoveList::MAXCOUNT];
+    bool isFails[MoveList::MAXCOUNT];
+    for (int i = 0; i < moveList.count(); ++i) {
+        int fromIndex { MoveList::fromIndex(moveList.at(i)) }, toIndex { MoveList::toIndex(moveList.at(i)) };
+        int eatPieceIndex { position_.movePiece(fromIndex, toIndex) };
+        childHashs[i] = position_.hash();
+        position_.undoMovePiece(fromIndex, toIndex, eatPieceIndex);
+        isFails[i] = ply + 1 >= MAXPLY || isOnPath(childHashs[i]);
+    }
+
+    path_.append(hash);
+    while (true) {
+        // 汇总子结点: 或结点取最小证明数、否证数之和, 与结点反之
+        quint32 pn { 0 }, dn { 0 }, bestNumber { INFINITE }, secondNumber { INFINITE };
+        int bestIndex { -1 }, length { isOr ? MAXPLY : 0 };
+        for (int i = 0; i < moveList.count(); ++i) {
+            Entry child { isFails[i] ? Entry { INFINITE, 0, 0 } : entry(childHashs[i]) };
+            if (child.pn == 0)
+                length = isOr ? qMin(length, child.length + 1) : qMax(length, child.length + 1);
+            (isOr ? dn : pn) = addNumber(isOr ? dn : pn, isOr ? child.dn : child.pn);
+            quint32 number { isOr ? child.pn : child.dn };
+            if (bestIndex < 0 || number < bestNumber) {
+                secondNumber = bestIndex < 0 ? INFINITE : bestNumber;
+                bestNumber = number;
+                bestIndex = i;
+            } else
+                secondNumber = qMin(secondNumber, number);
+        }
+        (isOr ? pn : dn) = bestNumber;
+
+        table_[hash] = { pn, dn, length };
+        if (pn >= thpn || dn >= thdn || isAborted_)
+            break;
+
+        // 最佳子结点的阈值: 不超过次佳者加一, 另一数按本结点余量放宽
+        Entry best { entry(childHashs[bestIndex]) };
+        quint32 childThpn { isOr ? qMin(thpn, addNumber(secondNumber, 1)) : addNumber(thpn - pn, best.pn) };
+        quint32 childThdn { isOr ? addNumber(thdn - dn, best.dn) : qMin(thdn, addNumber(secondNumber, 1)) };
+        int fromIndex { MoveList::fromIndex(moveList.at(bestIndex)) },
+            toIndex { MoveList::toIndex(moveList.at(bestIndex)) };
+        int eatPieceIndex { position_.movePiece(fromIndex, toIndex) };
+        mid(childThpn, childThdn, ply + 1);
+        position_.undoMovePiece(fromIndex, toIndex, eatPieceIndex);
+    }
+    path_.removeLast();
+}
+
+void MateSolver::generateMoves(MoveList& moveList)
+{
+    PieceColor color { position_.sideColor() };
+    position_.generateLegalMoves(color, moveList);
+    if (color != attackColor_ || !limits_.checksOnly)
+        return;
+
+    // 连将杀: 攻方只保留将军着法
+    MoveList allMoves { moveList };
+    moveList.clear();
+    for (PackedMove move : allMoves) {
+        int fromIndex { MoveList::fromIndex(move) }, toIndex { MoveList::toIndex(move) };
+        int eatPieceIndex { position_.movePiece(fromIndex, toIndex) };
+        bool isCheck { position_.isKilled(otherColor(color)) };
+        position_.undoMovePiece(fromIndex, toIndex, eatPieceIndex);
+        if (isCheck)
+            moveList.append(fromIndex, toIndex);
+    }
+}
+
+void MateSolver::extract(QList<MateMove>& solution)
+{
+    MoveList moveList;
+    generateMoves(moveList);
+    bool isOr { isOrNode() };
+    int bestLength { MAXPLY };
+    QList<PackedMove> moves;
+    for (PackedMove move : moveList) {
+        int fromIndex { MoveList::fromIndex(move) }, toIndex { MoveList::toIndex(move) };
+        int eatPieceIndex { position_.movePiece(fromIndex, toIndex) };
+        Entry child { entry(position_.hash()) };
+        position_.undoMovePiece(fromIndex, toIndex, eatPieceIndex);
+        if (child.pn != 0)
+            continue;
+
+        // 攻方取步数最少的一着, 守方全部应着均已证明
+        if (!isOr) {
+            moves.append(move);
+        } else if (child.length < bestLength) {
+            bestLength = child.length;
+            moves = { move };
+        }
+    }
+
+    for (int i = 0; i < moves.count(); ++i) {
+        int fromIndex { MoveList::fromIndex(moves.at(i)) }, toIndex { MoveList::toIndex(moves.at(i)) };
+        int eatPieceIndex { position_.movePiece(fromIndex, toIndex) };
+        // 攻方着后守方尚有应着, 守方着后攻方必有后着
+        bool hasNext { !isOr || entry(position_.hash()).length > 0 };
+        solution.append({ moves.at(i), hasNext, i < moves.count() - 1 });
+        if (hasNext)
+            extract(solution);
+        position_.undoMovePiece(fromIndex, toIndex, eatPieceIndex);
+    }
+}
+
+MateSolver::Entry MateSolver::entry(quint64 hash) const
+{
+    return table_.value(hash, { 1, 1, 0 });
+}
+
+bool MateSolver::isOnPath(quint64 hash) const
+{
+    return path_.contains(hash);
+}
+
+bool MateSolver::isLimited()
+{
+    isAborted_ = isAborted_ || (limits_.nodes > 0 && nodes_ > limits_.nodes)
+        || (limits_.memory > 0 && qint64(table_.count()) * ENTRYBYTES > limits_.memory);
+
+    return isAborted_;
+}
@@ -0,0 +1,92 @@
+#ifndef MATESOLVER_H
+#define MATESOLVER_H
+// 杀局解题: 深度优先证明数搜索(df-pn), 在局面核心的副本上进行, 可在界面之外单独运行
+// 攻方(开始时的走棋方)结点为或结点, 守方结点为与结点; 证明数、否证数存于以局面键索引的表中,
+// 子结点未超过阈值前不回到父结点, 表随展开的结点增长, 由结点数、内存上限终止.
+// 守方无着可走(将死或困毙)即证明; 攻方无着、局面在当前路径上重复或超过最大深度即否证
+// (重复按路径判定, 存表后偏于保守, 只会漏解不会误解).
+// 证明后按表中记录的杀棋步数提取解答树: 攻方取最快成杀的一着, 守方列出全部应着
+// (df-pn找到的杀法不保证最短).
+
+#include "movelist.h"
+#include "position.h"
+
+#include <QHash>
+#include <QList>
+#include <QString>
+
+// 搜索限制: 结点数、表占用内存(字节), 0为不限; 攻方是否只走将军着法(连将杀)
+struct MateLimits {
+    quint64 nodes { 10000000 };
+    qint64 memory { 256 * 1024 * 1024 };
+    bool checksOnly { true };
+};
+
+// 解答树的一着, 按先序排列(后着先于变着), 与ManualMoveAppendIterator的追加顺序一致
+struct MateMove {
+    PackedMove move { 0 };
+    bool hasNext { false };
+    bool hasOther { false };
+};
+
+struct MateResult {
+    enum Status {
+        UNKNOWN, // 达到限制, 未有结论
+        PROVEN,
+        DISPROVEN
+    };
+
+    Status status { UNKNOWN };
+    int length { 0 }; // 守方最顽强应着下的杀棋半回合数
+    QList<MateMove> solution {};
+    quint64 nodes { 0 };
+    qint64 msecs { 0 };
+    qint64 memory { 0 };
+
+    // 结论: 如"3步杀"、"无杀"、"未解出"
+    QString statusString() const;
+    // 结论及吞吐量: 如"3步杀, 结点: 1024 (51200/秒), 内存: 48KB, 用时: 20毫秒"
+    QString toString() const;
+};
+
+class MateSolver {
+public:
+    static const int MAXPLY { 127 };
+
+    explicit MateSolver(const Position& position, const MateLimits& limits = {});
+
+    MateSolver(const MateSolver&) = delete;
+    MateSolver& operator=(const MateSolver&) = delete;
+
+    MateResult solve();
+
+private:
+    struct Entry {
+        quint32 pn;
+        quint32 dn;
+        int length; // 已证明时的杀棋半回合数
+    };
+
+    // 表中每项(含散列结点开销)的估计字节数
+    static const int ENTRYBYTES { 48 };
+
+    void mid(quint32 thpn, quint32 thdn, int ply);
+    void generateMoves(MoveList& moveList);
+    void extract(QList<MateMove>& solution);
+
+    Entry entry(quint64 hash) const;
+    bool isOrNode() const { return position_.sideColor() == attackColor_; }
+    bool isOnPath(quint64 hash) const;
+    bool isLimited();
+
+    Position position_;
+    PieceColor attackColor_;
+    MateLimits limits_;
+
+    QHash<quint64, Entry> table_ {};
+    QList<quint64> path_ {};
+    quint64 nodes_ { 0 };
+    bool isAborted_ { false };
+};
+
+#endif // MATESOLVER_H
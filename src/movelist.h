@@ -0,0 +1,54 @@
+#ifndef MOVELIST_H
+#define MOVELIST_H
+// 定长着法列表: 栈上分配, 着法压缩为16位(低8位起点序号, 高8位终点序号)
+
+#include <QtGlobal>
+
+using PackedMove = quint16;
+
+// 着法生成阶段: 全部、仅吃子、仅不吃子
+enum class MoveStage {
+    ALL,
+    CAPTURE,
+    QUIET
+};
+
+class MoveList {
+public:
+    static const int MAXCOUNT { 128 }; // 一方全部可走着法数的上限
+
+    static PackedMove pack(int fromIndex, int toIndex) { return PackedMove(fromIndex | (toIndex << 8)); }
+    static int fromIndex(PackedMove move) { return move & 0xFF; }
+    static int toIndex(PackedMove move) { return move >> 8; }
+
+    void clear() { count_ = 0; }
+    void append(int fromIndex, int toIndex)
+    {
+        Q_ASSERT(count_ < MAXCOUNT);
+        moves_[count_++] = pack(fromIndex, toIndex);
+    }
+
+    int count() const { return count_; }
+    bool isEmpty() const { return count_ == 0; }
+    PackedMove at(int index) const { return moves_[index]; }
+    bool contains(int fromIndex, int toIndex) const
+    {
+        PackedMove move { pack(fromIndex, toIndex) };
+        for (int i = 0; i < count_; ++i)
+            if (moves_[i] == move)
+                return true;
+
+        return false;
+    }
+
+    PackedMove* begin() { return moves_; }
+    PackedMove* end() { return moves_ + count_; }
+    const PackedMove* begin() const { return moves_; }
+    const PackedMove* end() const { return moves_ + count_; }
+
+private:
+    PackedMove moves_[MAXCOUNT];
+    int count_ { 0 };
+};
+
+#endif // MOVELIST_H
@@ -0,0 +1,151 @@
+#include "moveorder.h"
+#include "evaluation.h"
+#include "piece.h"
+#include "position.h"
+
+// 各类着法的排序得分基数, 历史得分限制在反击着法之下
+static const int FIRSTMOVESCORE { 1 << 30 };
+static const int CAPTURESCORE { 1 << 29 };
+static const int KILLERSCORE { 1 << 28 };
+static const int COUNTERSCORE { 1 << 27 };
+static const int HISTORYMAX { 1 << 20 };
+
+void OrderStats::add(const OrderStats& other)
+{
+    cutNodes += other.cutNodes;
+    firstMoveCuts += other.firstMoveCuts;
+    cutMoveIndexs += other.cutMoveIndexs;
+}
+
+double OrderStats::firstMoveCutRate() const
+{
+    return cutNodes ? 100.0 * firstMoveCuts / cutNodes : 0;
+}
+
+double OrderStats::averageCutIndex() const
+{
+    return cutNodes ? double(cutMoveIndexs) / cutNodes : 0;
+}
+
+MoveOrder::MoveOrder()
+{
+    clear();
+}
+
+void MoveOrder::clear()
+{
+    for (auto& counterMoves : counterMoves_)
+        for (auto& move : counterMoves)
+            move = 0;
+
+    for (auto& historys : history_)
+        for (auto& value : historys)
+            value = 0;
+
+    newSearch();
+}
+
+void MoveOrder::newSearch()
+{
+    for (auto& killers : killers_)
+        for (auto& move : killers)
+            move = 0;
+
+    for (auto& historys : history_)
+        for (auto& value : historys)
+            value /= 2;
+
+    stats_.clear();
+}
+
+void MoveOrder::sort(const Position& position, MoveList& moveList, int ply,
+    PackedMove firstMove, PackedMove prevMove) const
+{
+    Q_ASSERT(ply < MAXPLY);
+    PackedMove counter { counterMove(prevMove) };
+    PackedMove* moves { moveList.begin() };
+    int scores[MoveList::MAXCOUNT];
+    // 插入排序: 着法数量少, 且保持生成顺序稳定
+    for (int i = 0; i < moveList.count(); ++i) {
+        PackedMove move { moves[i] };
+        int score { moveScore(position, move, ply, firstMove, counter) }, j { i };
+        for (; j > 0 && scores[j - 1] < score; --j) {
+            scores[j] = scores[j - 1];
+            moves[j] = moves[j - 1];
+        }
+        scores[j] = score;
+        moves[j] = move;
+    }
+}
+
+void MoveOrder::updateCutoff(const Position& position, PackedMove move, int ply, int depth,
+    PackedMove prevMove, const PackedMove* triedQuiets, int triedCount)
+{
+    if (position.hasPiece(MoveList::toIndex(move)))
+        return;
+
+    if (killers_[ply][0] != move) {
+        killers_[ply][1] = killers_[ply][0];
+        killers_[ply][0] = move;
+    }
+
+    if (prevMove)
+        counterMoves_[MoveList::fromIndex(prevMove)][MoveList::toIndex(prevMove)] = move;
+
+    int bonus { depth * depth };
+    addHistory(move, bonus);
+    for (int i = 0; i < triedCount; ++i)
+        if (triedQuiets[i] != move)
+            addHistory(triedQuiets[i], -bonus);
+}
+
+void MoveOrder::recordCutoff(int moveIndex)
+{
+    ++stats_.cutNodes;
+    if (moveIndex == 1)
+        ++stats_.firstMoveCuts;
+    stats_.cutMoveIndexs += moveIndex;
+}
+
+PackedMove MoveOrder::counterMove(PackedMove prevMove) const
+{
+    return prevMove ? counterMoves_[MoveList::fromIndex(prevMove)][MoveList::toIndex(prevMove)] : 0;
+}
+
+int MoveOrder::history(PackedMove move) const
+{
+    return history_[MoveList::fromIndex(move)][MoveList::toIndex(move)];
+}
+
+int MoveOrder::moveScore(const Position& position, PackedMove move, int ply,
+    PackedMove firstMove, PackedMove counter) const
+{
+    if (move == firstMove)
+        return FIRSTMOVESCORE;
+
+    int fromIndex { MoveList::fromIndex(move) }, toIndex { MoveList::toIndex(move) };
+    int eatPieceIndex { position.pieceIndex(toIndex) };
+    if (eatPieceIndex != Position::NOPIECE)
+        return CAPTURESCORE + Evaluation::KINDVALUES[int(Position::kind(eatPieceIndex))] * 16
+            - Evaluation::KINDVALUES[int(Position::kind(position.pieceIndex(fromIndex)))];
+
+    if (move == killers_[ply][0])
+        return KILLERSCORE + 1;
+    if (move == killers_[ply][1])
+        return KILLERSCORE;
+    if (move == counter)
+        return COUNTERSCORE;
+
+    return history_[fromIndex][toIndex];
+}
+
+void MoveOrder::addHistory(PackedMove move, int bonus)
+{
+    int& value { history_[MoveList::fromIndex(move)][MoveList::toIndex(move)] };
+    value += bonus;
+    // 超出上限时整表减半, 保持相对大小
+    if (qAbs(value) >= HISTORYMAX)
+        for (auto& historys : history_)
+            for (auto& other : historys)
+                other /= 2;
+}
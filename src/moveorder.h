@@ -0,0 +1,64 @@
+#ifndef MOVEORDER_H
+#define MOVEORDER_H
+// 着法排序: 置换表(主要变例)着法最先, 吃子按MVV-LVA(被吃子价值高、吃子价值低者先),
+// 其后为本层两个杀手着法、对上一着的反击着法, 其余不吃子着法按历史表(起止位置90x90)得分.
+// 每个搜索线程各有一份, 不共享; 另统计截断结点的首着截断率, 以衡量排序效果.
+
+#include "movelist.h"
+
+class Position;
+
+// 着法排序统计: 发生截断的结点数, 其中首着即截断的结点数, 截断着法序号(从1起)之和
+struct OrderStats {
+    quint64 cutNodes { 0 };
+    quint64 firstMoveCuts { 0 };
+    quint64 cutMoveIndexs { 0 };
+
+    void add(const OrderStats& other);
+    void clear() { *this = OrderStats {}; }
+
+    // 首着截断率(百分比), 截断着法的平均序号
+    double firstMoveCutRate() const;
+    double averageCutIndex() const;
+};
+
+class MoveOrder {
+public:
+    static const int MAXPLY { 64 };
+    static const int KILLERNUM { 2 };
+
+    MoveOrder();
+
+    // 全部清空; 新一次搜索时清空杀手与统计, 历史得分减半保留
+    void clear();
+    void newSearch();
+
+    // 按排序得分由高至低稳定排序, prevMove为上一着(0为无)
+    void sort(const Position& position, MoveList& moveList, int ply,
+        PackedMove firstMove, PackedMove prevMove) const;
+
+    // 着法引起截断: 不吃子着法更新杀手、反击着法及历史表, 此前已试的不吃子着法历史减分
+    // 须在走子前的局面上调用
+    void updateCutoff(const Position& position, PackedMove move, int ply, int depth,
+        PackedMove prevMove, const PackedMove* triedQuiets, int triedCount);
+
+    // 记录截断结点及截断着法的序号(从1起)
+    void recordCutoff(int moveIndex);
+
+    PackedMove killer(int ply, int index) const { return killers_[ply][index]; }
+    PackedMove counterMove(PackedMove prevMove) const;
+    int history(PackedMove move) const;
+    const OrderStats& stats() const { return stats_; }
+
+private:
+    int moveScore(const Position& position, PackedMove move, int ply,
+        PackedMove firstMove, PackedMove counter) const;
+    void addHistory(PackedMove move, int bonus);
+
+    PackedMove killers_[MAXPLY][KILLERNUM];
+    PackedMove counterMoves_[90][90];
+    int history_[90][90];
+    OrderStats stats_;
+};
+
+#endif // MOVEORDER_H
@@ -0,0 +1,78 @@
+#include "perft.h"
+#include "board.h"
+#include "piece.h"
+#include "position.h"
+#include "seatbase.h"
+
+const QList<Perft::Reference> Perft::REFERENCES {
+    { "rnbakabnr/9/1c5c1/p1p1p1p1p/9/9/P1P1P1P1P/1C5C1/9/RNBAKABNR w",
+        { 44, 1920, 79666, 3290240, 133312995 } },
+    { "r1ba1a3/4kn3/2n1b4/pNp1p1p1p/4c4/6P2/P1P2R2P/1CcC5/9/2BAKAB2 w",
+        { 38, 1128, 43929, 1339047, 53112976 } },
+    { "1cbak4/9/n2a5/2p1p3p/5cp2/2n2N3/6PCP/3AB4/2C6/3A1K1N1 w",
+        { 7, 281, 8620, 326201, 10369923 } },
+    { "5a3/3k5/3aR4/9/5r3/5n3/9/3A1A3/5K3/2BC2B2 w",
+        { 25, 424, 9850, 202884, 4739553 } },
+};
+
+static PieceColor otherColor(PieceColor color)
+{
+    return color == PieceColor::RED ? PieceColor::BLACK : PieceColor::RED;
+}
+
+bool Perft::setFEN(Board& board, const QString& fen, PieceColor& color)
+{
+    QStringList fields { fen.split(' ', Qt::SkipEmptyParts) };
+    if (fields.isEmpty())
+        return false;
+
+    color = (fields.count() > 1 && fields.at(1) == "b") ? PieceColor::BLACK : PieceColor::RED;
+    return board.setFEN(fields.at(0), color);
+}
+
+quint64 Perft::perft(Position& position, PieceColor color, int depth)
+{
+    if (depth <= 0)
+        return 1;
+
+    MoveList moveList;
+    position.generateLegalMoves(color, moveList);
+    if (depth == 1)
+        return moveList.count();
+
+    quint64 nodes { 0 };
+    for (PackedMove move : moveList) {
+        int fromIndex { MoveList::fromIndex(move) }, toIndex { MoveList::toIndex(move) };
+        int eatPieceIndex { position.movePiece(fromIndex, toIndex) };
+        nodes += perft(position, otherColor(color), depth - 1);
+        position.undoMovePiece(fromIndex, toIndex, eatPieceIndex);
+    }
+
+    return nodes;
+}
+
+QList<QPair<PackedMove, quint64>> Perft::divide(Position& position, PieceColor color, int depth)
+{
+    QList<QPair<PackedMove, quint64>> moveNodes;
+    MoveList moveList;
+    position.generateLegalMoves(color, moveList);
+    for (PackedMove move : moveList) {
+        int fromIndex { MoveList::fromIndex(move) }, toIndex { MoveList::toIndex(move) };
+        int eatPieceIndex { position.movePiece(fromIndex, toIndex) };
+        moveNodes.append({ move, perft(position, otherColor(color), depth - 1) });
+        position.undoMovePiece(fromIndex, toIndex, eatPieceIndex);
+    }
+
+    return moveNodes;
+}
+
+QString Perft::moveString(PackedMove move)
+{
+    QString str;
+    for (int index : { MoveList::fromIndex(move), MoveList::toIndex(move) }) {
+        Coord coord { SeatBase::getCoord(index) };
+        str.append(QChar('a' + coord.second)).append(QChar('0' + coord.first));
+    }
+
+    return str;
+}
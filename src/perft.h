@@ -0,0 +1,36 @@
+#ifndef PERFT_H
+#define PERFT_H
+// 走子生成验证与计时: 统计某局面指定深度的叶结点数
+
+#include "movelist.h"
+#include <QList>
+#include <QPair>
+
+class Board;
+class Position;
+enum class PieceColor;
+
+namespace Perft {
+
+// 参考局面(含走棋方)及深度1~5的叶结点数
+struct Reference {
+    const char* fen;
+    quint64 nodes[5];
+};
+
+extern const QList<Reference> REFERENCES;
+
+// 棋子部分交由Board::setFEN设置, 走棋方"b"为黑方, 缺省为红方
+bool setFEN(Board& board, const QString& fen, PieceColor& color);
+
+quint64 perft(Position& position, PieceColor color, int depth);
+
+// 分着法统计: 每个合法着法及其后的叶结点数
+QList<QPair<PackedMove, quint64>> divide(Position& position, PieceColor color, int depth);
+
+// 着法坐标字符串, 如"h2e2"(列a~i, 行0~9由下至上)
+QString moveString(PackedMove move);
+
+};
+
+#endif // PERFT_H
@@ -1,9 +1,10 @@
 #include "piece.h"
 #include "piecebase.h"
 
-Piece::Piece(PieceColor color, PieceKind kind)
+Piece::Piece(PieceColor color, PieceKind kind, int index)
     : color_(color)
     , kind_(kind)
+    , index_(index)
     , seat_(Q_NULLPTR)
 {
 }
@@ -11,13 +12,14 @@ Piece::Piece(PieceColor color, PieceKind kind)
 QList<QList<QList<Piece*>>> Piece::creatPieces()
 {
     QList<QList<QList<Piece*>>> pieces;
+    int index { 0 };
     for (PieceColor color : PieceBase::ALLCOLORS) {
         QList<QList<Piece*>> colorPieces;
         for (PieceKind kind : PieceBase::ALLKINDS) {
             int num { PieceBase::getKindNum(kind) };
             QList<Piece*> kindPieces;
             for (int i = 0; i < num; ++i)
-                kindPieces.append(new Piece(color, kind));
+                kindPieces.append(new Piece(color, kind, index++));
             colorPieces.append(kindPieces);
         }
         pieces.append(colorPieces);
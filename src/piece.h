@@ -31,6 +31,7 @@ public:
 
     PieceColor color() const { return color_; }
     PieceKind kind() const { return kind_; }
+    int index() const { return index_; }
 
     bool isLive() const { return seat_; }
     Seat* seat() const { return seat_; }
@@ -43,10 +44,11 @@ public:
     QString toString() const;
 
 private:
-    Piece(PieceColor color, PieceKind kind);
+    Piece(PieceColor color, PieceKind kind, int index);
 
     const PieceColor color_;
     const PieceKind kind_;
+    const int index_; // 棋子序号(Position内的棋子索引)
 
     Seat* seat_;
 };
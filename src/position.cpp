@@ -0,0 +1,772 @@
+#include "position.h"
+#include "evaluation.h"
+#include "piece.h"
+#include "seatbase.h"
+#include "seattable.h"
+
+static const int COLNUM { 9 };
+
+// 每方各种类棋子序号的起始偏移(按PieceKind顺序), 最后一项为每方棋子总数
+static const int KINDOFFSET[] { 0, 1, 3, 5, 7, 9, 11, 16 };
+
+// 每方棋子序号对应的种类
+static const PieceKind KINDS[] {
+    PieceKind::KING, PieceKind::ADVISOR, PieceKind::ADVISOR, PieceKind::BISHOP, PieceKind::BISHOP,
+    PieceKind::KNIGHT, PieceKind::KNIGHT, PieceKind::ROOK, PieceKind::ROOK,
+    PieceKind::CANNON, PieceKind::CANNON, PieceKind::PAWN, PieceKind::PAWN,
+    PieceKind::PAWN, PieceKind::PAWN, PieceKind::PAWN
+};
+
+// Zobrist键: 每方每种棋子在每个位置一个随机数, 另加黑方走棋一个随机数
+// 同色同种棋子键值相同, 以使不同棋子对象构成的相同局面键值一致
+struct ZobristTable {
+    quint64 pieceKeys[14][90];
+    quint64 sideKey;
+};
+
+constexpr quint64 splitMix64(quint64& state)
+{
+    quint64 value { state += 0x9E3779B97F4A7C15ULL };
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+constexpr ZobristTable makeZobristTable()
+{
+    ZobristTable table {};
+    quint64 state { 0x20230101ULL };
+    for (auto& keys : table.pieceKeys)
+        for (auto& key : keys)
+            key = splitMix64(state);
+    table.sideKey = splitMix64(state);
+
+    return table;
+}
+
+static constexpr ZobristTable ZOBRIST { makeZobristTable() };
+
+static quint64 pieceKey(int pieceIndex, int index)
+{
+    return ZOBRIST.pieceKeys[pieceIndex / Position::COLORPIECENUM * 7
+        + int(Position::kind(pieceIndex))][index];
+}
+
+static const SeatTable::ChangeTable& changeTable(ChangeType ct)
+{
+    switch (ct) {
+    case ChangeType::SYMMETRY_H:
+        return SeatTable::SYMMETRYHTABLE;
+    case ChangeType::SYMMETRY_V:
+        return SeatTable::SYMMETRYVTABLE;
+    case ChangeType::ROTATE:
+        return SeatTable::ROTATETABLE;
+    default:
+        return SeatTable::NOCHANGETABLE;
+    }
+}
+
+static int getRow(int index) { return index / COLNUM; }
+static int getCol(int index) { return index % COLNUM; }
+
+#ifdef CCHESS_BITBOARD
+// 某位置所在行、列中由行列占位查表所得的位置
+static Bitboard lineBits(int index, quint16 rowMask, quint16 colMask)
+{
+    int col { getCol(index) };
+    Bitboard bits { Bitboard::rowBits(getRow(index), rowMask) };
+    for (; colMask; colMask &= colMask - 1)
+        bits |= Bitboard::seat(int(qCountTrailingZeroBits(colMask)) * COLNUM + col);
+
+    return bits;
+}
+#endif
+
+// 与帅(将)同行、同列或斜邻(马腿、象眼)的位置: 其上棋子离开或进入可能改变帅(将)所受攻击
+static bool isKingLine(int kingIndex, int index)
+{
+    int rowDiff { qAbs(getRow(kingIndex) - getRow(index)) },
+        colDiff { qAbs(getCol(kingIndex) - getCol(index)) };
+    return rowDiff == 0 || colDiff == 0 || (rowDiff == 1 && colDiff == 1);
+}
+
+// 步进棋子(除车、炮外)的走子表, 按种类及所在方在编译期选定
+template <PieceKind Kind, SeatSide Side>
+static const SeatTable::StepTable& stepTable()
+{
+    if constexpr (Kind == PieceKind::KING)
+        return SeatTable::KINGTABLE;
+    else if constexpr (Kind == PieceKind::ADVISOR)
+        return SeatTable::ADVISORTABLE[int(Side)];
+    else if constexpr (Kind == PieceKind::BISHOP)
+        return SeatTable::BISHOPTABLE;
+    else if constexpr (Kind == PieceKind::KNIGHT)
+        return SeatTable::KNIGHTTABLE;
+    else
+        return SeatTable::PAWNTABLE[int(Side)];
+}
+
+int SymmetryTransform::seatIndex(int index) const
+{
+    return changeTable(seatChange).indexs[index];
+}
+
+PieceColor SymmetryTransform::color(PieceColor color) const
+{
+    return exchange ? PieceColor((int(color) + 1) % 2) : color;
+}
+
+PackedMove SymmetryTransform::move(PackedMove move) const
+{
+    return MoveList::pack(seatIndex(MoveList::fromIndex(move)), seatIndex(MoveList::toIndex(move)));
+}
+
+Position::Position()
+    : bottomColor_(PieceColor::RED)
+{
+    clear();
+}
+
+void Position::clear()
+{
+    for (auto& pieceIndex : seats_)
+        pieceIndex = NOPIECE;
+
+    for (auto& index : pieceSeats_)
+        index = NOSEAT;
+
+    sideColor_ = PieceColor::RED;
+    hash_ = 0;
+    values_[0] = values_[1] = 0;
+#ifdef CCHESS_BITBOARD
+    for (auto& bits : kindBits_)
+        bits = Bitboard::zero();
+    for (auto& bits : rowBits_)
+        bits = 0;
+    for (auto& bits : colBits_)
+        bits = 0;
+#endif
+}
+
+PieceColor Position::color(int pieceIndex)
+{
+    return PieceColor(pieceIndex / COLORPIECENUM);
+}
+
+PieceKind Position::kind(int pieceIndex)
+{
+    return KINDS[pieceIndex % COLORPIECENUM];
+}
+
+int Position::firstPieceIndex(PieceColor color, PieceKind kind)
+{
+    return int(color) * COLORPIECENUM + KINDOFFSET[int(kind)];
+}
+
+int Position::lastPieceIndex(PieceColor color, PieceKind kind)
+{
+    return int(color) * COLORPIECENUM + KINDOFFSET[int(kind) + 1];
+}
+
+int Position::kingIndex(PieceColor color) const
+{
+    return pieceSeats_[firstPieceIndex(color, PieceKind::KING)];
+}
+
+void Position::setPiece(int index, int pieceIndex)
+{
+    int oldPieceIndex { seats_[index] };
+    if (oldPieceIndex != NOPIECE) {
+        pieceSeats_[oldPieceIndex] = NOSEAT;
+        hash_ ^= pieceKey(oldPieceIndex, index);
+        values_[oldPieceIndex / COLORPIECENUM] -= pieceValue(oldPieceIndex, index);
+    }
+
+    if (pieceIndex != NOPIECE) {
+        pieceSeats_[pieceIndex] = index;
+        hash_ ^= pieceKey(pieceIndex, index);
+        values_[pieceIndex / COLORPIECENUM] += pieceValue(pieceIndex, index);
+    }
+
+#ifdef CCHESS_BITBOARD
+    if (oldPieceIndex != NOPIECE)
+        togglePieceBits(oldPieceIndex, index);
+    if (pieceIndex != NOPIECE)
+        togglePieceBits(pieceIndex, index);
+    if ((oldPieceIndex == NOPIECE) != (pieceIndex == NOPIECE))
+        toggleOccupancy(index);
+#endif
+    seats_[index] = pieceIndex;
+}
+
+int Position::movePiece(int fromIndex, int toIndex)
+{
+    int pieceIndex { seats_[fromIndex] }, eatPieceIndex { seats_[toIndex] };
+    if (eatPieceIndex != NOPIECE) {
+        pieceSeats_[eatPieceIndex] = NOSEAT;
+        hash_ ^= pieceKey(eatPieceIndex, toIndex);
+        values_[eatPieceIndex / COLORPIECENUM] -= pieceValue(eatPieceIndex, toIndex);
+    }
+
+    pieceSeats_[pieceIndex] = toIndex;
+    seats_[toIndex] = pieceIndex;
+    seats_[fromIndex] = NOPIECE;
+    hash_ ^= pieceKey(pieceIndex, fromIndex) ^ pieceKey(pieceIndex, toIndex);
+    values_[pieceIndex / COLORPIECENUM] += pieceValue(pieceIndex, toIndex) - pieceValue(pieceIndex, fromIndex);
+#ifdef CCHESS_BITBOARD
+    toggleMoveBits(pieceIndex, eatPieceIndex, fromIndex, toIndex);
+#endif
+    changeSide();
+
+    return eatPieceIndex;
+}
+
+void Position::undoMovePiece(int fromIndex, int toIndex, int eatPieceIndex)
+{
+    int pieceIndex { seats_[toIndex] };
+    pieceSeats_[pieceIndex] = fromIndex;
+    seats_[fromIndex] = pieceIndex;
+    hash_ ^= pieceKey(pieceIndex, fromIndex) ^ pieceKey(pieceIndex, toIndex);
+    values_[pieceIndex / COLORPIECENUM] += pieceValue(pieceIndex, fromIndex) - pieceValue(pieceIndex, toIndex);
+
+    seats_[toIndex] = eatPieceIndex;
+    if (eatPieceIndex != NOPIECE) {
+        pieceSeats_[eatPieceIndex] = toIndex;
+        hash_ ^= pieceKey(eatPieceIndex, toIndex);
+        values_[eatPieceIndex / COLORPIECENUM] += pieceValue(eatPieceIndex, toIndex);
+    }
+#ifdef CCHESS_BITBOARD
+    toggleMoveBits(pieceIndex, eatPieceIndex, fromIndex, toIndex);
+#endif
+    changeSide();
+}
+
+#ifdef CCHESS_BITBOARD
+void Position::togglePieceBits(int pieceIndex, int index)
+{
+    kindBits_[pieceIndex / COLORPIECENUM * 7 + int(kind(pieceIndex))] ^= Bitboard::seat(index);
+}
+
+void Position::toggleOccupancy(int index)
+{
+    int row { getRow(index) }, col { getCol(index) };
+    rowBits_[row] ^= quint16(1 << col);
+    colBits_[col] ^= quint16(1 << row);
+}
+
+void Position::toggleMoveBits(int pieceIndex, int eatPieceIndex, int fromIndex, int toIndex)
+{
+    togglePieceBits(pieceIndex, fromIndex);
+    togglePieceBits(pieceIndex, toIndex);
+    toggleOccupancy(fromIndex);
+    if (eatPieceIndex != NOPIECE)
+        togglePieceBits(eatPieceIndex, toIndex);
+    else
+        toggleOccupancy(toIndex);
+}
+
+Bitboard Position::attackBits(PieceColor color) const
+{
+    // 每个棋子的攻击位置各成一个位棋盘, 最后一并求并
+    Bitboard pieceAttacks[COLORPIECENUM];
+    int count { 0 };
+    SeatSide homeSide { getHomeSide(color) };
+    PieceColor otherColor { PieceColor((int(color) + 1) % 2) };
+    int first { int(color) * COLORPIECENUM };
+    for (int pieceIndex = first; pieceIndex < first + COLORPIECENUM; ++pieceIndex) {
+        int fromIndex { pieceSeats_[pieceIndex] };
+        if (fromIndex == NOSEAT)
+            continue;
+
+        PieceKind pieceKind { kind(pieceIndex) };
+        int row { getRow(fromIndex) }, col { getCol(fromIndex) };
+        const SeatTable::LineMoves& colMoves { SeatTable::COLLINETABLE.moves[row][colBits_[col]] };
+        Bitboard& bits { pieceAttacks[count++] };
+        if (pieceKind == PieceKind::ROOK || pieceKind == PieceKind::CANNON) {
+            const SeatTable::LineMoves& rowMoves { SeatTable::ROWLINETABLE.moves[col][rowBits_[row]] };
+            bits = pieceKind == PieceKind::ROOK ? lineBits(fromIndex, rowMoves.rook, colMoves.rook)
+                                                : lineBits(fromIndex, rowMoves.cannonAttack, colMoves.cannonAttack);
+            continue;
+        }
+
+        bits = Bitboard::zero();
+        const SeatTable::Steps& steps { SeatBase::getStepTable(pieceKind, homeSide).steps[fromIndex] };
+        for (int i = 0; i < steps.count; ++i)
+            if (steps.blockIndexs[i] == SeatTable::NOINDEX || !hasPiece(steps.blockIndexs[i]))
+                bits |= Bitboard::seat(steps.indexs[i]);
+
+        // 将帅对面
+        if (pieceKind == PieceKind::KING)
+            bits |= lineBits(fromIndex, 0, colMoves.rook & colBits_[col]) & pieceBits(otherColor, PieceKind::KING);
+    }
+
+    return Bitboard::unite(pieceAttacks, count);
+}
+#endif
+
+void Position::setSideColor(PieceColor color)
+{
+    if (color != sideColor_)
+        changeSide();
+}
+
+void Position::changeSide()
+{
+    sideColor_ = PieceColor((int(sideColor_) + 1) % 2);
+    hash_ ^= ZOBRIST.sideKey;
+}
+
+CanonicalKey Position::canonicalKey() const
+{
+    // 候选变换按底方分列, 变换后均为红方在下; 红方在下时首项即本局面(键与hash()相同)
+    static const SymmetryTransform transforms[][4] {
+        { { ChangeType::NOCHANGE, false }, { ChangeType::SYMMETRY_H, false },
+            { ChangeType::ROTATE, true }, { ChangeType::SYMMETRY_V, true } },
+        { { ChangeType::ROTATE, false }, { ChangeType::SYMMETRY_V, false },
+            { ChangeType::NOCHANGE, true }, { ChangeType::SYMMETRY_H, true } }
+    };
+    const SymmetryTransform* candidates { transforms[int(bottomColor_)] };
+    const qint8* seatIndexs[4];
+    quint64 keys[4];
+    for (int i = 0; i < 4; ++i) {
+        seatIndexs[i] = changeTable(candidates[i].seatChange).indexs;
+        keys[i] = candidates[i].color(sideColor_) == PieceColor::BLACK ? ZOBRIST.sideKey : 0;
+    }
+
+    for (int pieceIndex = 0; pieceIndex < PIECENUM; ++pieceIndex) {
+        int index { pieceSeats_[pieceIndex] };
+        if (index == NOSEAT)
+            continue;
+
+        // 本色与对换颜色后的键值行
+        int kindIndex { int(kind(pieceIndex)) }, colorIndex { pieceIndex / COLORPIECENUM };
+        const quint64* pieceKeys[] { ZOBRIST.pieceKeys[colorIndex * 7 + kindIndex],
+            ZOBRIST.pieceKeys[(1 - colorIndex) * 7 + kindIndex] };
+        for (int i = 0; i < 4; ++i)
+            keys[i] ^= pieceKeys[candidates[i].exchange][seatIndexs[i][index]];
+    }
+
+    int minIndex { 0 };
+    for (int i = 1; i < 4; ++i)
+        if (keys[i] < keys[minIndex])
+            minIndex = i;
+
+    return { keys[minIndex], candidates[minIndex] };
+}
+
+void Position::setBottomColor(PieceColor bottomColor)
+{
+    bottomColor_ = bottomColor;
+    // 位置分表随底方而定, 需重新计算
+    computeValues();
+}
+
+SeatSide Position::getHomeSide(PieceColor color) const
+{
+    return color == bottomColor_ ? SeatSide::BOTTOM : SeatSide::TOP;
+}
+
+int Position::pieceValue(int pieceIndex, int index) const
+{
+    int homeIndex { color(pieceIndex) == bottomColor_ ? index : SEATNUM - 1 - index };
+    return Evaluation::pieceSquareValue(kind(pieceIndex), homeIndex);
+}
+
+void Position::computeValues()
+{
+    values_[0] = values_[1] = 0;
+    for (int pieceIndex = 0; pieceIndex < PIECENUM; ++pieceIndex)
+        if (pieceSeats_[pieceIndex] != NOSEAT)
+            values_[pieceIndex / COLORPIECENUM] += pieceValue(pieceIndex, pieceSeats_[pieceIndex]);
+}
+
+int Position::getMoveIndexs(int fromIndex, int* toIndexs) const
+{
+    int pieceIndex { seats_[fromIndex] };
+    if (pieceIndex == NOPIECE)
+        return 0;
+
+    MoveIndexsFunc func { moveIndexsFunc<MoveStage::ALL>(kind(pieceIndex), getHomeSide(color(pieceIndex))) };
+    return (this->*func)(fromIndex, toIndexs);
+}
+
+template <PieceKind Kind, SeatSide Side, MoveStage Stage>
+int Position::getKindMoveIndexs(int fromIndex, int* toIndexs) const
+{
+    PieceColor pieceColor { color(seats_[fromIndex]) };
+    int count { 0 };
+
+    // 目标位置无棋子(吃子阶段除外)或为对方棋子(不吃子阶段除外)时可走
+    auto append_ = [&](int toIndex) {
+        int toPieceIndex { seats_[toIndex] };
+        if (toPieceIndex == NOPIECE ? Stage != MoveStage::CAPTURE
+                                    : Stage != MoveStage::QUIET && color(toPieceIndex) != pieceColor)
+            toIndexs[count++] = toIndex;
+    };
+
+    if constexpr (Kind == PieceKind::ROOK || Kind == PieceKind::CANNON) {
+        constexpr bool isRook { Kind == PieceKind::ROOK };
+#ifdef CCHESS_BITBOARD
+        // 行列占位查表, 吃子、不吃子阶段再按占位筛选; 按后前左右、由近及远的次序添加, 与逐位置查看的次序一致
+        auto appendLine_ = [&](unsigned bits, unsigned occupancy, int pos, int base, int step) {
+            if constexpr (Stage == MoveStage::CAPTURE)
+                bits &= occupancy;
+            else if constexpr (Stage == MoveStage::QUIET)
+                bits &= ~occupancy;
+            unsigned lowBits { bits & ((1u << pos) - 1) }, highBits { bits & ~((2u << pos) - 1) };
+            while (lowBits) {
+                int bit { 31 - int(qCountLeadingZeroBits(quint32(lowBits))) };
+                lowBits ^= 1u << bit;
+                append_(base + bit * step);
+            }
+            for (; highBits; highBits &= highBits - 1)
+                append_(base + int(qCountTrailingZeroBits(quint32(highBits))) * step);
+        };
+
+        int row { getRow(fromIndex) }, col { getCol(fromIndex) };
+        const SeatTable::LineMoves& colMoves { SeatTable::COLLINETABLE.moves[row][colBits_[col]] };
+        const SeatTable::LineMoves& rowMoves { SeatTable::ROWLINETABLE.moves[col][rowBits_[row]] };
+        appendLine_(isRook ? colMoves.rook : colMoves.cannon, colBits_[col], row, col, COLNUM);
+        appendLine_(isRook ? rowMoves.rook : rowMoves.cannon, rowBits_[row], col, row * COLNUM, 1);
+#else
+        const SeatTable::Rays& rays { SeatTable::RAYTABLE.rays[fromIndex] };
+        for (int dir = 0; dir < SeatTable::DIRECTIONNUM; ++dir) {
+            bool skiped { false }; // 炮是否已越过炮架
+            for (int i = 0; i < rays.count[dir]; ++i) {
+                int toIndex { rays.indexs[dir][i] };
+                bool has { hasPiece(toIndex) };
+                if (isRook || skiped) {
+                    if (isRook || has)
+                        append_(toIndex);
+                    if (has)
+                        break;
+                } else if (has) {
+                    // 不吃子时炮无需越过炮架
+                    if constexpr (Stage == MoveStage::QUIET)
+                        break;
+                    skiped = true;
+                } else
+                    append_(toIndex);
+            }
+        }
+#endif
+    } else {
+        const SeatTable::Steps& steps { stepTable<Kind, Side>().steps[fromIndex] };
+        for (int i = 0; i < steps.count; ++i) {
+            // 仅马、相(象)有马腿、象眼
+            if constexpr (Kind == PieceKind::KNIGHT || Kind == PieceKind::BISHOP) {
+                if (hasPiece(steps.blockIndexs[i]))
+                    continue;
+            }
+            append_(steps.indexs[i]);
+        }
+    }
+
+    return count;
+}
+
+template <MoveStage Stage>
+Position::MoveIndexsFunc Position::moveIndexsFunc(PieceKind kind, SeatSide homeSide)
+{
+    static constexpr MoveIndexsFunc funcs[][SeatTable::SIDENUM] {
+        { &Position::getKindMoveIndexs<PieceKind::KING, SeatSide::BOTTOM, Stage>,
+            &Position::getKindMoveIndexs<PieceKind::KING, SeatSide::TOP, Stage> },
+        { &Position::getKindMoveIndexs<PieceKind::ADVISOR, SeatSide::BOTTOM, Stage>,
+            &Position::getKindMoveIndexs<PieceKind::ADVISOR, SeatSide::TOP, Stage> },
+        { &Position::getKindMoveIndexs<PieceKind::BISHOP, SeatSide::BOTTOM, Stage>,
+            &Position::getKindMoveIndexs<PieceKind::BISHOP, SeatSide::TOP, Stage> },
+        { &Position::getKindMoveIndexs<PieceKind::KNIGHT, SeatSide::BOTTOM, Stage>,
+            &Position::getKindMoveIndexs<PieceKind::KNIGHT, SeatSide::TOP, Stage> },
+        { &Position::getKindMoveIndexs<PieceKind::ROOK, SeatSide::BOTTOM, Stage>,
+            &Position::getKindMoveIndexs<PieceKind::ROOK, SeatSide::TOP, Stage> },
+        { &Position::getKindMoveIndexs<PieceKind::CANNON, SeatSide::BOTTOM, Stage>,
+            &Position::getKindMoveIndexs<PieceKind::CANNON, SeatSide::TOP, Stage> },
+        { &Position::getKindMoveIndexs<PieceKind::PAWN, SeatSide::BOTTOM, Stage>,
+            &Position::getKindMoveIndexs<PieceKind::PAWN, SeatSide::TOP, Stage> }
+    };
+    return funcs[int(kind)][int(homeSide)];
+}
+
+bool Position::isSeatAttacked(int index, PieceColor color) const
+{
+    auto isPiece_ = [&](int pieceIndex, PieceKind pieceKind) {
+        return pieceIndex != NOPIECE && Position::color(pieceIndex) == color
+            && kind(pieceIndex) == pieceKind;
+    };
+
+    // 位置上为对方将帅时, 需检查将帅对面
+    int pieceIndex { seats_[index] };
+    bool isOtherKing { pieceIndex != NOPIECE && Position::color(pieceIndex) != color
+        && kind(pieceIndex) == PieceKind::KING };
+
+#ifdef CCHESS_BITBOARD
+    // 车、将帅对面: 行列各方向第一个棋子; 炮: 越过炮架后的第一个棋子. 由行列占位查表直接得到这些位置
+    int row { getRow(index) }, col { getCol(index) };
+    quint16 rowOccupancy { rowBits_[row] }, colOccupancy { colBits_[col] };
+    const SeatTable::LineMoves& rowMoves { SeatTable::ROWLINETABLE.moves[col][rowOccupancy] };
+    const SeatTable::LineMoves& colMoves { SeatTable::COLLINETABLE.moves[row][colOccupancy] };
+    auto isLinePiece_ = [&](unsigned rowMask, unsigned colMask, bool isFirst) {
+        for (; rowMask; rowMask &= rowMask - 1) {
+            int linePieceIndex { seats_[row * COLNUM + int(qCountTrailingZeroBits(rowMask))] };
+            if (isFirst ? isPiece_(linePieceIndex, PieceKind::ROOK) : isPiece_(linePieceIndex, PieceKind::CANNON))
+                return true;
+        }
+        for (; colMask; colMask &= colMask - 1) {
+            int linePieceIndex { seats_[int(qCountTrailingZeroBits(colMask)) * COLNUM + col] };
+            if (isFirst ? isPiece_(linePieceIndex, PieceKind::ROOK)
+                        || (isOtherKing && isPiece_(linePieceIndex, PieceKind::KING))
+                        : isPiece_(linePieceIndex, PieceKind::CANNON))
+                return true;
+        }
+        return false;
+    };
+    if (isLinePiece_(rowMoves.rook & rowOccupancy, colMoves.rook & colOccupancy, true)
+        || isLinePiece_(rowMoves.cannonAttack & rowOccupancy, colMoves.cannonAttack & colOccupancy, false))
+        return true;
+#else
+    // 车、将帅对面: 各方向第一个棋子; 炮: 各方向第二个棋子
+    const SeatTable::Rays& rays { SeatTable::RAYTABLE.rays[index] };
+    for (int dir = 0; dir < SeatTable::DIRECTIONNUM; ++dir) {
+        bool skiped { false };
+        for (int i = 0; i < rays.count[dir]; ++i) {
+            int rayPieceIndex { seats_[rays.indexs[dir][i]] };
+            if (rayPieceIndex == NOPIECE)
+                continue;
+
+            if (skiped) {
+                if (isPiece_(rayPieceIndex, PieceKind::CANNON))
+                    return true;
+                break;
+            }
+
+            if (isPiece_(rayPieceIndex, PieceKind::ROOK)
+                || (isOtherKing && isPiece_(rayPieceIndex, PieceKind::KING)))
+                return true;
+            skiped = true;
+        }
+    }
+#endif
+
+    // 马: 由该位置反查马的位置, 马腿在马的一侧
+    const SeatTable::Steps& knightSteps { SeatTable::KNIGHTATTACKTABLE.steps[index] };
+    for (int i = 0; i < knightSteps.count; ++i)
+        if (isPiece_(seats_[knightSteps.indexs[i]], PieceKind::KNIGHT)
+            && !hasPiece(knightSteps.blockIndexs[i]))
+            return true;
+
+    // 兵
+    const SeatTable::Steps& pawnSteps {
+        SeatTable::PAWNATTACKTABLE[int(getHomeSide(color))].steps[index]
+    };
+    for (int i = 0; i < pawnSteps.count; ++i)
+        if (isPiece_(seats_[pawnSteps.indexs[i]], PieceKind::PAWN))
+            return true;
+
+    // 帅将: 走子表对称
+    const SeatTable::Steps& kingSteps { SeatTable::KINGTABLE.steps[index] };
+    for (int i = 0; i < kingSteps.count; ++i)
+        if (isPiece_(seats_[kingSteps.indexs[i]], PieceKind::KING))
+            return true;
+
+    // 仕士、相象: 各只有两个, 直接查其走子表
+    for (PieceKind pieceKind : { PieceKind::ADVISOR, PieceKind::BISHOP }) {
+        const SeatTable::StepTable& stepTable { SeatBase::getStepTable(pieceKind, getHomeSide(color)) };
+        for (int attackPieceIndex = firstPieceIndex(color, pieceKind);
+             attackPieceIndex < lastPieceIndex(color, pieceKind); ++attackPieceIndex) {
+            int fromIndex { pieceSeats_[attackPieceIndex] };
+            if (fromIndex == NOSEAT)
+                continue;
+
+            const SeatTable::Steps& steps { stepTable.steps[fromIndex] };
+            for (int i = 0; i < steps.count; ++i)
+                if (steps.indexs[i] == index
+                    && (steps.blockIndexs[i] == SeatTable::NOINDEX || !hasPiece(steps.blockIndexs[i])))
+                    return true;
+        }
+    }
+
+    return false;
+}
+
+bool Position::isFace() const
+{
+    int redIndex { kingIndex(PieceColor::RED) }, blackIndex { kingIndex(PieceColor::BLACK) };
+    Q_ASSERT(redIndex != NOSEAT && blackIndex != NOSEAT);
+
+    int col { getCol(redIndex) };
+    if (col != getCol(blackIndex))
+        return false;
+
+    int lowIndex { qMin(redIndex, blackIndex) }, upIndex { qMax(redIndex, blackIndex) };
+    for (int index = lowIndex + COLNUM; index < upIndex; index += COLNUM)
+        if (hasPiece(index))
+            return false;
+
+    return true;
+}
+
+bool Position::isKilled(PieceColor color) const
+{
+    int kingSeatIndex { kingIndex(color) };
+    Q_ASSERT(kingSeatIndex != NOSEAT);
+
+    return isSeatAttacked(kingSeatIndex, PieceColor((int(color) + 1) % 2));
+}
+
+bool Position::isFaceOrKilled(int fromIndex, int toIndex)
+{
+    // 将帅对面已由isKilled一并检查
+    PieceColor pieceColor { color(seats_[fromIndex]) };
+    int eatPieceIndex { movePiece(fromIndex, toIndex) };
+    bool result { isKilled(pieceColor) };
+    undoMovePiece(fromIndex, toIndex, eatPieceIndex);
+
+    return result;
+}
+
+void Position::generateLegalMoves(PieceColor color, MoveList& moveList, MoveStage stage)
+{
+    // 按生成阶段、所在方选定整方的特化生成函数
+    static constexpr ColorMovesFunc funcs[][SeatTable::SIDENUM] {
+        { &Position::appendColorMoves<SeatSide::BOTTOM, MoveStage::ALL>,
+            &Position::appendColorMoves<SeatSide::TOP, MoveStage::ALL> },
+        { &Position::appendColorMoves<SeatSide::BOTTOM, MoveStage::CAPTURE>,
+            &Position::appendColorMoves<SeatSide::TOP, MoveStage::CAPTURE> },
+        { &Position::appendColorMoves<SeatSide::BOTTOM, MoveStage::QUIET>,
+            &Position::appendColorMoves<SeatSide::TOP, MoveStage::QUIET> }
+    };
+
+    moveList.clear();
+    (this->*funcs[int(stage)][int(getHomeSide(color))])(color, kingIndex(color), isKilled(color), moveList);
+}
+
+void Position::generateLegalMoves(int fromIndex, MoveList& moveList, MoveStage stage)
+{
+    moveList.clear();
+    int pieceIndex { seats_[fromIndex] };
+    if (pieceIndex == NOPIECE)
+        return;
+
+    PieceColor pieceColor { color(pieceIndex) };
+    PieceKind pieceKind { kind(pieceIndex) };
+    SeatSide homeSide { getHomeSide(pieceColor) };
+    MoveIndexsFunc func { stage == MoveStage::CAPTURE ? moveIndexsFunc<MoveStage::CAPTURE>(pieceKind, homeSide)
+            : stage == MoveStage::QUIET               ? moveIndexsFunc<MoveStage::QUIET>(pieceKind, homeSide)
+                                                      : moveIndexsFunc<MoveStage::ALL>(pieceKind, homeSide) };
+    int toIndexs[MAXMOVENUM];
+    int count { (this->*func)(fromIndex, toIndexs) };
+    appendLegalMoves(fromIndex, toIndexs, count, kingIndex(pieceColor), isKilled(pieceColor), moveList);
+}
+
+bool Position::hasAnyLegalMove(PieceColor color)
+{
+    int kingSeatIndex { kingIndex(color) };
+    bool isChecked { isKilled(color) };
+    // 与appendLegalMoves的判断一致, 需试走的着法暂存
+    MoveList tryCaptures, tryQuiets;
+    int first { int(color) * COLORPIECENUM };
+    for (int pieceIndex = first; pieceIndex < first + COLORPIECENUM; ++pieceIndex) {
+        int fromIndex { pieceSeats_[pieceIndex] };
+        if (fromIndex == NOSEAT)
+            continue;
+
+        int toIndexs[MAXMOVENUM];
+        int count { getMoveIndexs(fromIndex, toIndexs) };
+        bool fromKingLine { fromIndex == kingSeatIndex || isKingLine(kingSeatIndex, fromIndex) };
+        for (int i = 0; i < count; ++i) {
+            int toIndex { toIndexs[i] }, toPieceIndex { seats_[toIndex] };
+            bool isCapture { toPieceIndex != NOPIECE };
+            if (isCapture && kind(toPieceIndex) == PieceKind::KING)
+                return true;
+
+            if (!fromKingLine && !isKingLine(kingSeatIndex, toIndex)) {
+                if (!isChecked)
+                    return true;
+                if (!isCapture)
+                    continue;
+            }
+
+            (isCapture ? tryCaptures : tryQuiets).append(fromIndex, toIndex);
+        }
+    }
+
+    for (const MoveList* moveList : { &tryCaptures, &tryQuiets })
+        for (PackedMove move : *moveList)
+            if (!isFaceOrKilled(MoveList::fromIndex(move), MoveList::toIndex(move)))
+                return true;
+
+    return false;
+}
+
+GameState Position::gameState()
+{
+    if (hasAnyLegalMove(sideColor_))
+        return GameState::ONGOING;
+
+    return isKilled(sideColor_) ? GameState::CHECKMATE : GameState::STALEMATE;
+}
+
+bool Position::isLegalMove(PackedMove move)
+{
+    int fromIndex { MoveList::fromIndex(move) }, toIndex { MoveList::toIndex(move) };
+    if (fromIndex >= SEATNUM || toIndex >= SEATNUM || seats_[fromIndex] == NOPIECE
+        || color(seats_[fromIndex]) != sideColor_)
+        return false;
+
+    MoveList moveList;
+    generateLegalMoves(fromIndex, moveList);
+    return moveList.contains(fromIndex, toIndex);
+}
+
+void Position::appendLegalMoves(int fromIndex, const int* toIndexs, int count,
+    int kingSeatIndex, bool isChecked, MoveList& moveList)
+{
+    bool fromKingLine { fromIndex == kingSeatIndex || isKingLine(kingSeatIndex, fromIndex) };
+    for (int i = 0; i < count; ++i) {
+        int toIndex { toIndexs[i] }, toPieceIndex { seats_[toIndex] };
+        bool isCapture { toPieceIndex != NOPIECE };
+
+        // 可吃对方帅(将)时不再试走, 与Board::filterKilledRule一致
+        if (isCapture && kind(toPieceIndex) == PieceKind::KING) {
+            moveList.append(fromIndex, toIndex);
+            continue;
+        }
+
+        bool needTry { fromKingLine || isKingLine(kingSeatIndex, toIndex) };
+        if (isChecked && !needTry && !isCapture)
+            continue;
+
+        if ((needTry || isChecked) && isFaceOrKilled(fromIndex, toIndex))
+            continue;
+
+        moveList.append(fromIndex, toIndex);
+    }
+}
+
+template <PieceKind Kind, SeatSide Side, MoveStage Stage>
+void Position::appendKindMoves(PieceColor color, int kingSeatIndex, bool isChecked, MoveList& moveList)
+{
+    int last { lastPieceIndex(color, Kind) };
+    for (int pieceIndex = firstPieceIndex(color, Kind); pieceIndex < last; ++pieceIndex) {
+        int fromIndex { pieceSeats_[pieceIndex] };
+        if (fromIndex == NOSEAT)
+            continue;
+
+        int toIndexs[MAXMOVENUM];
+        int count { getKindMoveIndexs<Kind, Side, Stage>(fromIndex, toIndexs) };
+        appendLegalMoves(fromIndex, toIndexs, count, kingSeatIndex, isChecked, moveList);
+    }
+}
+
+template <SeatSide Side, MoveStage Stage>
+void Position::appendColorMoves(PieceColor color, int kingSeatIndex, bool isChecked, MoveList& moveList)
+{
+    // 按棋子序号的种类顺序逐种生成, 着法次序与逐个棋子生成一致
+    appendKindMoves<PieceKind::KING, Side, Stage>(color, kingSeatIndex, isChecked, moveList);
+    appendKindMoves<PieceKind::ADVISOR, Side, Stage>(color, kingSeatIndex, isChecked, moveList);
+    appendKindMoves<PieceKind::BISHOP, Side, Stage>(color, kingSeatIndex, isChecked, moveList);
+    appendKindMoves<PieceKind::KNIGHT, Side, Stage>(color, kingSeatIndex, isChecked, moveList);
+    appendKindMoves<PieceKind::ROOK, Side, Stage>(color, kingSeatIndex, isChecked, moveList);
+    appendKindMoves<PieceKind::CANNON, Side, Stage>(color, kingSeatIndex, isChecked, moveList);
+    appendKindMoves<PieceKind::PAWN, Side, Stage>(color, kingSeatIndex, isChecked, moveList);
+}
@@ -0,0 +1,181 @@
+#ifndef POSITION_H
+#define POSITION_H
+
+#include "movelist.h"
+#include <QtGlobal>
+
+#ifdef CCHESS_BITBOARD
+#include "bitboard.h"
+#endif
+
+#include <type_traits>
+
+enum class PieceColor;
+enum class PieceKind;
+enum class SeatSide;
+enum class ChangeType;
+
+// 局面的对称变换: 位置变换(NOCHANGE、SYMMETRY_H、ROTATE、SYMMETRY_V)及是否对换双方颜色(含走棋方)
+// 各变换均为对合, 同一变换也将变换后局面的位置、着法映射回原局面
+struct SymmetryTransform {
+    ChangeType seatChange;
+    bool exchange;
+
+    int seatIndex(int index) const;
+    PieceColor color(PieceColor color) const;
+    PackedMove move(PackedMove move) const;
+};
+
+// 规范键: 局面经左右对称、旋转并对换颜色及二者复合所得的等价局面(均以红方在下)中最小的Zobrist键,
+// 及所施的变换. 等价局面的规范键相同, 可供棋谱库、局面索引及去重每类只存一项
+struct CanonicalKey {
+    quint64 key;
+    SymmetryTransform transform;
+};
+
+// 对局状态: 走棋方无合法着法时, 正被将军为被杀, 否则为困毙(均判走棋方负)
+enum class GameState {
+    ONGOING,
+    CHECKMATE,
+    STALEMATE
+};
+
+// 局面核心类(值类型)
+// 90个单字节位置存放棋子序号, 32个单字节棋子存放位置序号, 互为索引.
+// 棋子序号与Piece::creatPieces的生成顺序一致: 红方0~15, 黑方16~31,
+// 每方按帅(将)、仕(士)、相(象)、马、车、炮、兵(卒)排列.
+// 走子、撤销、将军判断均在数组上完成, 不分配堆内存.
+// 随置子、走子增量维护64位Zobrist键(含走棋方), 及双方子力与位置分.
+// 可平凡复制(约150字节, 位棋盘后端约300字节): Board::snapshot()取得的副本可交给各工作线程独立走子、分析.
+class Position {
+public:
+    static const int SEATNUM { 90 };
+    static const int PIECENUM { 32 };
+    static const int COLORPIECENUM { 16 };
+    static const int MAXMOVENUM { 17 }; // 单个棋子最多可走位置数(车、炮)
+    static const int NOPIECE { -1 };
+    static const int NOSEAT { -1 };
+
+    Position();
+
+    void clear();
+
+    // 棋子序号的颜色、种类
+    static PieceColor color(int pieceIndex);
+    static PieceKind kind(int pieceIndex);
+    // 某颜色、种类棋子序号的起止范围[first, last)
+    static int firstPieceIndex(PieceColor color, PieceKind kind);
+    static int lastPieceIndex(PieceColor color, PieceKind kind);
+
+    int pieceIndex(int index) const { return seats_[index]; }
+    int seatIndex(int pieceIndex) const { return pieceSeats_[pieceIndex]; }
+    bool hasPiece(int index) const { return seats_[index] != NOPIECE; }
+    int kingIndex(PieceColor color) const;
+
+    // 与Seat::setPiece同步: 原位置棋子离开棋盘, 新棋子置入位置
+    void setPiece(int index, int pieceIndex);
+
+    // 走子与撤销(同时交换走棋方), 返回被吃棋子序号
+    int movePiece(int fromIndex, int toIndex);
+    void undoMovePiece(int fromIndex, int toIndex, int eatPieceIndex);
+    int makeMove(PackedMove move) { return movePiece(MoveList::fromIndex(move), MoveList::toIndex(move)); }
+    void undoMove(PackedMove move, int eatPieceIndex)
+    {
+        undoMovePiece(MoveList::fromIndex(move), MoveList::toIndex(move), eatPieceIndex);
+    }
+
+    // 着法的起点为走棋方棋子, 且在其合法着法之中
+    bool isLegalMove(PackedMove move);
+
+    PieceColor sideColor() const { return sideColor_; }
+    void setSideColor(PieceColor color);
+    void changeSide();
+
+    quint64 hash() const { return hash_; }
+    CanonicalKey canonicalKey() const;
+
+    // 某方棋子的子力与位置分之和
+    int value(PieceColor color) const { return values_[int(color)]; }
+
+    PieceColor bottomColor() const { return bottomColor_; }
+    void setBottomColor(PieceColor bottomColor);
+    SeatSide getHomeSide(PieceColor color) const;
+
+    // 某位置棋子可走的位置(已排除规则、同色不允许的位置), 返回数量
+    int getMoveIndexs(int fromIndex, int* toIndexs) const;
+
+    // 某位置是否受某方棋子攻击: 由该位置沿车炮直线、马腿、兵向反查
+    // 位置上为对方将帅时, 将帅对面也视同受攻击
+    bool isSeatAttacked(int index, PieceColor color) const;
+
+    // 将帅是否对面, 某方是否正被将军(含将帅对面)
+    bool isFace() const;
+    bool isKilled(PieceColor color) const;
+
+    // 走子后是否将帅对面或己方被将军
+    bool isFaceOrKilled(int fromIndex, int toIndex);
+
+#ifdef CCHESS_BITBOARD
+    // 某方某种棋子所在位置; 某方全部棋子攻击的位置(九宫内与isSeatAttacked一致)
+    Bitboard pieceBits(PieceColor color, PieceKind kind) const { return kindBits_[int(color) * 7 + int(kind)]; }
+    Bitboard attackBits(PieceColor color) const;
+#endif
+
+    // 合法着法(某方全部棋子或某位置棋子), 可只生成吃子或不吃子着法
+    // 起止位置均不在己方帅(将)的行列及斜邻位置时, 着法不影响帅(将)的安危:
+    // 未被将军时直接合法, 被将军时不吃子即不合法; 其余着法才试走判断
+    void generateLegalMoves(PieceColor color, MoveList& moveList, MoveStage stage = MoveStage::ALL);
+    void generateLegalMoves(int fromIndex, MoveList& moveList, MoveStage stage = MoveStage::ALL);
+
+    // 某方是否有合法着法: 先找无需试走即合法的着法, 再试走其余着法(吃子在前), 找到一个即返回
+    bool hasAnyLegalMove(PieceColor color);
+    // 走棋方的对局状态
+    GameState gameState();
+
+private:
+    // 棋子在某位置的子力与位置分(位置分表以己方底线为准)
+    int pieceValue(int pieceIndex, int index) const;
+    void computeValues();
+
+    // 按棋子种类、所在方及生成阶段特化的走子生成: 种类与阶段的分支均在编译期确定.
+    // 整方生成时按种类顺序逐种展开; 单个位置生成时经查表分派一次
+    using MoveIndexsFunc = int (Position::*)(int, int*) const;
+    using ColorMovesFunc = void (Position::*)(PieceColor, int, bool, MoveList&);
+
+    template <PieceKind Kind, SeatSide Side, MoveStage Stage>
+    int getKindMoveIndexs(int fromIndex, int* toIndexs) const;
+    template <MoveStage Stage>
+    static MoveIndexsFunc moveIndexsFunc(PieceKind kind, SeatSide homeSide);
+
+    template <PieceKind Kind, SeatSide Side, MoveStage Stage>
+    void appendKindMoves(PieceColor color, int kingSeatIndex, bool isChecked, MoveList& moveList);
+    template <SeatSide Side, MoveStage Stage>
+    void appendColorMoves(PieceColor color, int kingSeatIndex, bool isChecked, MoveList& moveList);
+
+    // 筛除走后己方被将军的位置, 其余添加为着法
+    void appendLegalMoves(int fromIndex, const int* toIndexs, int count,
+        int kingSeatIndex, bool isChecked, MoveList& moveList);
+
+#ifdef CCHESS_BITBOARD
+    // 棋子置入或离开位置、走子或撤销时同步位棋盘及行列占位(均为异或, 撤销与走子相同)
+    void togglePieceBits(int pieceIndex, int index);
+    void toggleOccupancy(int index);
+    void toggleMoveBits(int pieceIndex, int eatPieceIndex, int fromIndex, int toIndex);
+#endif
+
+    qint8 seats_[SEATNUM];
+    qint8 pieceSeats_[PIECENUM];
+    PieceColor bottomColor_;
+    PieceColor sideColor_;
+    quint64 hash_;
+    int values_[2];
+#ifdef CCHESS_BITBOARD
+    Bitboard kindBits_[2 * 7];
+    quint16 rowBits_[SeatTable::ROWNUM]; // 每行占位, 按列号置位
+    quint16 colBits_[SeatTable::COLNUM]; // 每列占位, 按行号置位
+#endif
+};
+
+static_assert(std::is_trivially_copyable<Position>::value, "Position须可按值复制");
+
+#endif // POSITION_H
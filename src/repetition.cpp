@@ -0,0 +1,130 @@
+#include "repetition.h"
+#include "evaluation.h"
+#include "piece.h"
+#include "position.h"
+#include "seatbase.h"
+#include "seattable.h"
+
+static PieceColor otherColor(PieceColor color)
+{
+    return PieceColor((int(color) + 1) % 2);
+}
+
+QString Repetition::toString() const
+{
+    switch (kind) {
+    case RepetitionKind::IDLE:
+        return "局面重复, 闲着循环, 判和";
+    case RepetitionKind::PERPETUAL_CHECK:
+        return QString("局面重复, %1方长将, 判负").arg(loseColor == PieceColor::RED ? "红" : "黑");
+    case RepetitionKind::PERPETUAL_CHASE:
+        return QString("局面重复, %1方长捉, 判负").arg(loseColor == PieceColor::RED ? "红" : "黑");
+    default:
+        return {};
+    }
+}
+
+RepetitionHistory::RepetitionHistory()
+{
+    clear();
+}
+
+void RepetitionHistory::clear()
+{
+    entries_.clear();
+    for (auto& count : filter_)
+        count = 0;
+}
+
+void RepetitionHistory::push(quint64 hash, PackedMove move, bool isCapture)
+{
+    entries_.append({ hash, move, isCapture });
+    ++filter_[hash % FILTERSIZE];
+}
+
+void RepetitionHistory::pop()
+{
+    Q_ASSERT(!entries_.isEmpty());
+    --filter_[entries_.last().hash % FILTERSIZE];
+    entries_.removeLast();
+}
+
+Repetition RepetitionHistory::check(const Position& position) const
+{
+    quint64 hash { position.hash() };
+    if (filter_[hash % FILTERSIZE] == 0)
+        return {};
+
+    // 局面键含走棋方, 只会与同方走棋的局面相同
+    for (int index = entries_.count() - 1; index >= 0; --index) {
+        const Entry& entry { entries_.at(index) };
+        if (entry.isCapture)
+            break;
+
+        if (entry.hash == hash)
+            return classify(position, index);
+    }
+
+    return {};
+}
+
+bool RepetitionHistory::isChase(Position& position, int toIndex)
+{
+    int pieceIndex { position.pieceIndex(toIndex) };
+    PieceKind kind { Position::kind(pieceIndex) };
+    if (kind == PieceKind::KING || kind == PieceKind::PAWN)
+        return false;
+
+    PieceColor color { Position::color(pieceIndex) }, chasedColor { otherColor(color) };
+    bool chasedAtBottom { position.getHomeSide(chasedColor) == SeatSide::BOTTOM };
+    int toIndexs[Position::MAXMOVENUM];
+    int count { position.getMoveIndexs(toIndex, toIndexs) };
+    for (int i = 0; i < count; ++i) {
+        int chasedIndex { toIndexs[i] }, chasedPieceIndex { position.pieceIndex(chasedIndex) };
+        if (chasedPieceIndex == Position::NOPIECE)
+            continue;
+
+        PieceKind chasedKind { Position::kind(chasedPieceIndex) };
+        if (chasedKind == PieceKind::KING
+            || (chasedKind == PieceKind::PAWN
+                && (chasedIndex / SeatTable::COLNUM < 5) == chasedAtBottom))
+            continue;
+
+        // 试吃: 不合法则不算捉; 价值高于捉子者, 或吃后对方不能反吃(无保护), 即为捉
+        int eatPieceIndex { position.movePiece(toIndex, chasedIndex) };
+        bool isLegal { !position.isKilled(color) },
+            isProtected { position.isSeatAttacked(chasedIndex, chasedColor) };
+        position.undoMovePiece(toIndex, chasedIndex, eatPieceIndex);
+        if (isLegal
+            && (Evaluation::KINDVALUES[int(chasedKind)] > Evaluation::KINDVALUES[int(kind)] || !isProtected))
+            return true;
+    }
+
+    return false;
+}
+
+Repetition RepetitionHistory::classify(const Position& position, int startIndex) const
+{
+    // 由当前局面逐着撤销(循环内无吃子), 判断循环内各着走子后是否将军、捉子
+    Position cyclePosition { position };
+    bool isAllCheck[] { true, true }, isAllAttack[] { true, true };
+    for (int index = entries_.count() - 1; index >= startIndex; --index) {
+        PackedMove move { entries_.at(index).move };
+        int fromIndex { MoveList::fromIndex(move) }, toIndex { MoveList::toIndex(move) };
+        PieceColor color { Position::color(cyclePosition.pieceIndex(toIndex)) };
+        bool isCheck { cyclePosition.isKilled(otherColor(color)) };
+        bool isAttack { isCheck || isChase(cyclePosition, toIndex) };
+        isAllCheck[int(color)] = isAllCheck[int(color)] && isCheck;
+        isAllAttack[int(color)] = isAllAttack[int(color)] && isAttack;
+        cyclePosition.undoMovePiece(fromIndex, toIndex, Position::NOPIECE);
+    }
+
+    Repetition repetition { RepetitionKind::IDLE };
+    if (isAllAttack[0] != isAllAttack[1]) {
+        repetition.loseColor = isAllAttack[0] ? PieceColor::RED : PieceColor::BLACK;
+        repetition.kind = isAllCheck[int(repetition.loseColor)] ? RepetitionKind::PERPETUAL_CHECK
+                                                                : RepetitionKind::PERPETUAL_CHASE;
+    }
+
+    return repetition;
+}
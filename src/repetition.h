@@ -0,0 +1,65 @@
+#ifndef REPETITION_H
+#define REPETITION_H
+// 重复局面判别: 沿着法路径保存每着走子前的局面键, 走子后以计数过滤表O(1)判断是否可能重复,
+// 仅在可能重复时向前查找(遇吃子即止, 吃子前的局面不可能再现), 找到后再按亚洲规则判别循环类型:
+// 循环中一方着着将军或捉子(长打)而另一方不是, 则长打方判负(全为将军为长将, 否则为长捉);
+// 双方均长打或均不长打, 为闲着循环, 判和.
+// 着法排序、搜索只需压入、弹出着法, 判别时才在局面副本上逐着撤销, 计算各着是否将军、捉子.
+
+#include "movelist.h"
+
+#include <QList>
+#include <QString>
+
+class Position;
+enum class PieceColor;
+
+enum class RepetitionKind {
+    NONE,
+    IDLE,
+    PERPETUAL_CHECK,
+    PERPETUAL_CHASE
+};
+
+// 判别结果: 类型及违例(判负)方, 类型为NONE、IDLE时无违例方
+struct Repetition {
+    RepetitionKind kind { RepetitionKind::NONE };
+    PieceColor loseColor {};
+
+    QString toString() const;
+};
+
+class RepetitionHistory {
+public:
+    RepetitionHistory();
+
+    void clear();
+    int count() const { return entries_.count(); }
+
+    // 走子前压入局面键及着法, 撤销后弹出
+    void push(quint64 hash, PackedMove move, bool isCapture);
+    void pop();
+
+    // 当前局面(最后一着走子后)是否与路径上此前的局面重复, 重复时判别类型
+    Repetition check(const Position& position) const;
+
+    // 走子后, 落点上的棋子是否捉对方棋子: 可合法吃对方未过河兵(卒)与将帅以外的棋子,
+    // 且该子无保护或价值高于捉子者; 将帅与兵(卒)捉子不计
+    static bool isChase(Position& position, int toIndex);
+
+private:
+    static const int FILTERSIZE { 4096 };
+
+    struct Entry {
+        quint64 hash;
+        PackedMove move;
+        bool isCapture;
+    };
+
+    Repetition classify(const Position& position, int startIndex) const;
+
+    QList<Entry> entries_;
+    quint16 filter_[FILTERSIZE];
+};
+
+#endif // REPETITION_H
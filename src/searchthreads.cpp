@@ -0,0 +1,51 @@
+#include "searchthreads.h"
+
+#include <QThread>
+
+SearchThreads::SearchThreads(const Position& position, TranspositionTable* table, int threadCount)
+    : position_(position)
+    , table_(table)
+    , threadCount_(qMax(threadCount, 1))
+{
+}
+
+SearchResult SearchThreads::search(const SearchLimits& limits)
+{
+    table_->newSearch();
+
+    // 辅助线程只受深度限制, 由主线程结束时停止; 限定深度为1时深度无从错开, 不启用辅助线程
+    SearchLimits helperLimits { limits.depth, 0 };
+    QList<Engine*> helpers;
+    QList<QThread*> threads;
+    int threadCount { limits.depth == 1 ? 1 : threadCount_ };
+    for (int index = 1; index < threadCount; ++index) {
+        Engine* engine { new Engine(position_, table_, &stopped_) };
+        engine->setThreadIndex(index);
+        engine->setHistory(history_);
+        helpers.append(engine);
+        threads.append(QThread::create([engine, helperLimits]() { engine->search(helperLimits); }));
+        threads.last()->start();
+    }
+
+    Engine mainEngine(position_, table_, &stopped_);
+    mainEngine.setHistory(history_);
+    mainEngine.setIterationCallback(iterationCallback_);
+    SearchResult result { mainEngine.search(limits) };
+    stopped_ = true;
+
+    for (int index = 0; index < threads.count(); ++index) {
+        threads.at(index)->wait();
+        result.nodes += helpers.at(index)->nodes();
+        result.orderStats.add(helpers.at(index)->orderStats());
+        delete threads.at(index);
+        delete helpers.at(index);
+    }
+    stopped_ = false;
+
+    return result;
+}
+
+int SearchThreads::idealThreadCount()
+{
+    return qMax(QThread::idealThreadCount(), 1);
+}
@@ -0,0 +1,40 @@
+#ifndef SEARCHTHREADS_H
+#define SEARCHTHREADS_H
+// 多线程搜索(Lazy SMP): 主线程与若干辅助线程各持局面副本, 同时搜索同一局面,
+// 经共享置换表交换结果. 主线程控制时间与深度, 完成后通知辅助线程停止,
+// 以主线程的结果为准.
+
+#include "engine.h"
+
+#include <atomic>
+
+class SearchThreads {
+public:
+    SearchThreads(const Position& position, TranspositionTable* table, int threadCount);
+
+    // 结果中的结点数为全部线程之和
+    SearchResult search(const SearchLimits& limits);
+
+    // 可由其他线程调用, 在search开始前调用亦有效(该次搜索立即返回)
+    void stop() { stopped_ = true; }
+
+    // 各线程引擎共用的对局局面键历史
+    void setHistory(const RepetitionHistory& history) { history_ = history; }
+
+    // 主线程引擎每完成一次迭代时回调(在调用search的线程中), 结点数只含主线程
+    void setIterationCallback(const IterationCallback& callback) { iterationCallback_ = callback; }
+
+    int threadCount() const { return threadCount_; }
+    // 默认线程数: 处理器核心数
+    static int idealThreadCount();
+
+private:
+    Position position_;
+    TranspositionTable* table_;
+    int threadCount_;
+    RepetitionHistory history_;
+    IterationCallback iterationCallback_;
+    std::atomic<bool> stopped_ { false };
+};
+
+#endif // SEARCHTHREADS_H
@@ -1,19 +1,22 @@
 #include "seat.h"
 #include "boardseats.h"
 #include "piece.h"
+#include "position.h"
 #include "seatbase.h"
 
-Seat::Seat(const Coord& coord)
+Seat::Seat(Position* position, const Coord& coord)
     : piece_(Q_NULLPTR)
+    , position_(position)
     , coord_(coord)
+    , index_(SeatBase::getIndex(coord))
 {
 }
 
-QList<Seat*> Seat::creatSeats()
+QList<Seat*> Seat::creatSeats(Position* position)
 {
     QList<Seat*> seats;
     for (const Coord& coord : SeatBase::allCoord())
-        seats.append(new Seat(coord));
+        seats.append(new Seat(position, coord));
 
     return seats;
 }
@@ -32,6 +35,7 @@ void Seat::setPiece(Piece* piece)
         piece->setSeat(this);
 
     piece_ = piece;
+    position_->setPiece(index_, piece ? piece->index() : Position::NOPIECE);
 }
 
 void Seat::moveTo(Seat* toSeat, Piece* fillPiece)
@@ -39,6 +43,7 @@ void Seat::moveTo(Seat* toSeat, Piece* fillPiece)
     Piece* piece = piece_;
     setPiece(fillPiece); // 首先清空this与piece的联系
     toSeat->setPiece(piece); // 清空toSeat与toPiece的联系
+    position_->changeSide(); // 着法执行或撤销, 均交换走棋方
 }
 
 QList<QList<Coord>> Seat::canMove(const BoardSeats* boardSeats, SeatSide homeSide) const
@@ -9,15 +9,17 @@ enum class SeatSide;
 using Coord = QPair<int, int>;
 
 class Piece;
+class Position;
 
 // 位置类
 class Seat {
 public:
-    static QList<Seat*> creatSeats();
+    static QList<Seat*> creatSeats(Position* position);
 
     int row() const { return coord_.first; }
     int col() const { return coord_.second; }
     Coord coord() const { return coord_; }
+    int index() const { return index_; }
     bool isBottom() const;
 
     bool hasPiece() const { return piece_; }
@@ -33,10 +35,12 @@ public:
     QString toString() const;
 
 private:
-    Seat(const Coord& coord);
+    Seat(Position* position, const Coord& coord);
 
     Piece* piece_;
+    Position* position_; // 同步更新的局面核心
     const Coord coord_;
+    const int index_;
 };
 
 #endif // SEAT_H
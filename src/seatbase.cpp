@@ -1,9 +1,11 @@
 #include "seatbase.h"
 #include "boardpieces.h"
 #include "boardseats.h"
+#include "fencodec.h"
 #include "piece.h"
 #include "piecebase.h"
 #include "seat.h"
+#include "seattable.h"
 
 static const int ROWNUM { 10 };
 static const int COLNUM { 9 };
@@ -15,9 +17,6 @@ static const int KINGADVHIGHMINROW { 7 };
 static const int KINGADVMINCOL { 3 };
 static const int KINGADVMAXCOL { 5 };
 static const int BISHOPLOWMAXROW { 4 };
-static const QList<int> BISHOPROWS { { 0, 2, 4, 5, 7, 9 } };
-
-static const QChar FENSPLITCHAR { '/' };
 
 QList<Coord> SeatBase::allCoord()
 {
@@ -84,48 +83,12 @@ Coord SeatBase::changeCoord(const Coord& coord, ChangeType ct)
 
 QString SeatBase::pieCharsToFEN(const QString& pieChars)
 {
-    QString fen {};
-    int seatNum { SeatBase::getSeatNum() };
-    if (pieChars.count() != seatNum)
-        return fen;
-
-    for (int index = 0; index < seatNum; index += COLNUM) {
-        QString line { pieChars.mid(index, COLNUM) }, qstr {};
-        int num { 0 };
-        for (auto ch : line) {
-            if (ch != PieceBase::NULLCHAR) {
-                if (num != 0) {
-                    qstr.append(QString::number(num));
-                    num = 0;
-                }
-                qstr.append(ch);
-            } else
-                ++num;
-        }
-        if (num != 0)
-            qstr.append(QString::number(num));
-        fen.prepend(qstr).prepend(FENSPLITCHAR);
-    }
-    fen.remove(0, 1);
-
-    return fen;
+    return FenCodec::toFEN(pieChars);
 }
 
 QString SeatBase::FENToPieChars(const QString& fen)
 {
-    QStringList strList { fen.split(FENSPLITCHAR) };
-    if (strList.count() != ROWNUM)
-        return QString();
-
-    QString pieceChars;
-    for (auto& line : strList) {
-        QString string;
-        for (auto ch : line)
-            string.append(ch.isDigit() ? QString(ch.digitValue(), PieceBase::NULLCHAR) : ch);
-        pieceChars.prepend(string);
-    }
-
-    return pieceChars.size() == SeatBase::getSeatNum() ? pieceChars : QString();
+    return FenCodec::toPieChars(fen);
 }
 
 const QList<QPair<Coord, QPair<PieceColor, PieceKind>>>& SeatBase::getInitCoordColorKinds()
@@ -174,6 +137,22 @@ QPair<Coord, Coord> SeatBase::coordPair(const QString& rowcols)
         { rowcols.at(2).digitValue(), rowcols.at(3).digitValue() } };
 }
 
+bool SeatBase::iccsCoordPair(const QString& iccs, QPair<Coord, Coord>& coordPair)
+{
+    if (iccs.length() != 4)
+        return false;
+
+    for (int index : { 0, 2 }) {
+        int col { iccs.at(index).toLatin1() - 'a' }, row { iccs.at(index + 1).toLatin1() - '0' };
+        if (col < 0 || col >= SeatTable::COLNUM || row < 0 || row >= SeatTable::ROWNUM)
+            return false;
+
+        (index == 0 ? coordPair.first : coordPair.second) = { row, col };
+    }
+
+    return true;
+}
+
 bool SeatBase::less(Seat* first, Seat* last)
 {
     return first->row() < last->row();
@@ -209,25 +188,36 @@ QList<QList<Coord>> SeatBase::getCanMoveCoords(Piece* piece, const Coord& coord,
     return { moveCoords, ruleCoords, colorCoords };
 }
 
-QList<Coord> SeatBase::getCanMove(PieceKind kind, const Coord& coord, SeatSide homeSide)
+const SeatTable::StepTable& SeatBase::getStepTable(PieceKind kind, SeatSide homeSide)
 {
-    int row { coord.first }, col { coord.second };
     switch (kind) {
     case PieceKind::KING:
-        return kingCanMove(row, col);
+        return SeatTable::KINGTABLE;
     case PieceKind::ADVISOR:
-        return advisorCanMove(row, col, homeSide);
+        return SeatTable::ADVISORTABLE[int(homeSide)];
     case PieceKind::BISHOP:
-        return bishopCanMove(row, col);
+        return SeatTable::BISHOPTABLE;
     case PieceKind::KNIGHT:
-        return knightCanMove(row, col);
-    case PieceKind::PAWN:
-        return pawnCanMove(row, col, homeSide);
-    default:
-        return rookCannonCanMove(row, col);
+        return SeatTable::KNIGHTTABLE;
+    default: // PieceKind::PAWN
+        return SeatTable::PAWNTABLE[int(homeSide)];
     }
 }
 
+QList<Coord> SeatBase::getCanMove(PieceKind kind, const Coord& coord, SeatSide homeSide)
+{
+    int index { getIndex(coord) };
+    if (kind == PieceKind::ROOK || kind == PieceKind::CANNON)
+        return rookCannonCanMove(index);
+
+    QList<Coord> coords;
+    const SeatTable::Steps& steps { getStepTable(kind, homeSide).steps[index] };
+    for (int i = 0; i < steps.count; ++i)
+        coords.append(getCoord(steps.indexs[i]));
+
+    return coords;
+}
+
 QList<Coord> SeatBase::filterMoveRule(const BoardSeats* boardSeats, PieceKind kind,
     const Coord& coord, QList<Coord>& coords)
 {
@@ -266,40 +256,28 @@ QList<Coord> SeatBase::filterColorRule(const BoardSeats* boardSeats, PieceColor
 QList<Coord> SeatBase::filterBishopMoveRule(const BoardSeats* boardSeats,
     const Coord& coord, QList<Coord>& coords)
 {
-    int row { coord.first }, col { coord.second };
-    QList<Coord> ruleCoords;
-    QMutableListIterator<Coord> coordIter(coords);
-    while (coordIter.hasNext()) {
-        auto& coord = coordIter.next();
-        Coord midCoord = {
-            (row + coord.first) / 2,
-            (col + coord.second) / 2
-        };
-        if (boardSeats->getSeat(midCoord)->hasPiece()) {
-            ruleCoords.append({ midCoord, coord });
-            coordIter.remove();
-        }
-    }
-
-    return ruleCoords;
+    return filterBlockMoveRule(boardSeats, SeatTable::BISHOPTABLE.steps[getIndex(coord)], coords);
 }
 
 QList<Coord> SeatBase::filterKnightMoveRule(const BoardSeats* boardSeats,
     const Coord& coord, QList<Coord>& coords)
 {
-    int row { coord.first }, col { coord.second };
+    return filterBlockMoveRule(boardSeats, SeatTable::KNIGHTTABLE.steps[getIndex(coord)], coords);
+}
+
+QList<Coord> SeatBase::filterBlockMoveRule(const BoardSeats* boardSeats,
+    const SeatTable::Steps& steps, QList<Coord>& coords)
+{
+    // coords与走子表的目标位置顺序一致, 按表中象眼(马腿)位置重新筛选
     QList<Coord> ruleCoords;
-    QMutableListIterator<Coord> coordIter(coords);
-    while (coordIter.hasNext()) {
-        auto& coord = coordIter.next();
-        Coord midCoord = {
-            row + (coord.first - row) / 2,
-            col + (coord.second - col) / 2
-        };
-        if (boardSeats->getSeat(midCoord)->hasPiece()) {
-            ruleCoords.append({ midCoord, coord });
-            coordIter.remove();
-        }
+    coords.clear();
+    for (int i = 0; i < steps.count; ++i) {
+        Coord coord { getCoord(steps.indexs[i]) };
+        int blockIndex { steps.blockIndexs[i] };
+        if (boardSeats->position().hasPiece(blockIndex))
+            ruleCoords.append({ getCoord(blockIndex), coord });
+        else
+            coords.append(coord);
     }
 
     return ruleCoords;
@@ -424,133 +402,21 @@ QList<Coord> SeatBase::pawnCanPut(SeatSide homeSide)
     return coords;
 }
 
-QList<Coord> SeatBase::kingCanMove(int row, int col)
-{
-    QList<Coord> coords {
-        { row, col - 1 }, { row, col + 1 },
-        { row - 1, col }, { row + 1, col }
-    };
-
-    return filterValid(coords, isKingAdvCoord);
-}
-
-QList<Coord> SeatBase::advisorCanMove(int row, int col, SeatSide homeSide)
-{
-    if (col != KINGADVMINCOL + 1)
-        return { { (homeSide == SeatSide::BOTTOM ? MINROWCOL : KINGADVHIGHMINROW) + 1,
-            KINGADVMINCOL + 1 } };
-
-    return {
-        { row - 1, col - 1 }, { row - 1, col + 1 },
-        { row + 1, col - 1 }, { row + 1, col + 1 }
-    };
-}
-
-QList<Coord> SeatBase::bishopCanMove(int row, int col)
-{
-    QList<Coord> coords {
-        { row - 2, col - 2 }, { row - 2, col + 2 },
-        { row + 2, col - 2 }, { row + 2, col + 2 }
-    };
-
-    return filterValid(coords, isBishopCoord);
-}
-
-QList<Coord> SeatBase::knightCanMove(int row, int col)
-{
-    QList<Coord> coords {
-        { row - 2, col - 1 }, { row - 2, col + 1 },
-        { row - 1, col - 2 }, { row - 1, col + 2 },
-        { row + 1, col - 2 }, { row + 1, col + 2 },
-        { row + 2, col - 1 }, { row + 2, col + 1 }
-    };
-
-    return filterValid(coords, isValid);
-}
-
-QList<Coord> SeatBase::rookCannonCanMove(int fromRow, int fromCol)
+QList<Coord> SeatBase::rookCannonCanMove(int index)
 {
     QList<Coord> coords;
-    for (int row = fromRow - 1; row >= MINROWCOL; --row)
-        coords.append({ row, fromCol });
-
-    coords.append({ NONROWCOLVALUE, NONROWCOLVALUE }); // 更换方向时设置的哨卡
-    for (int row = fromRow + 1; row < ROWNUM; ++row)
-        coords.append({ row, fromCol });
-
-    coords.append({ NONROWCOLVALUE, NONROWCOLVALUE }); // 更换方向时设置的哨卡
-    for (int col = fromCol - 1; col >= MINROWCOL; --col)
-        coords.append({ fromRow, col });
+    const SeatTable::Rays& rays { SeatTable::RAYTABLE.rays[index] };
+    for (int dir = 0; dir < SeatTable::DIRECTIONNUM; ++dir) {
+        if (dir > 0)
+            coords.append({ NONROWCOLVALUE, NONROWCOLVALUE }); // 更换方向时设置的哨卡
 
-    coords.append({ NONROWCOLVALUE, NONROWCOLVALUE }); // 更换方向时设置的哨卡
-    for (int col = fromCol + 1; col < COLNUM; ++col)
-        coords.append({ fromRow, col });
-
-    return coords;
-}
-
-QList<Coord> SeatBase::pawnCanMove(int row, int col, SeatSide homeSide)
-{
-    QList<Coord> coords { { row + (homeSide == SeatSide::BOTTOM ? 1 : -1), col } };
-
-    // 已过河
-    if ((row > BISHOPLOWMAXROW) == (homeSide == SeatSide::BOTTOM))
-        coords.append({ { row, col - 1 }, { row, col + 1 } });
-
-    return filterValid(coords, isValid);
-}
-
-QList<Coord>& SeatBase::filterValid(QList<Coord>& coords, bool (*isFunc)(const Coord&))
-{
-    QMutableListIterator<Coord> coordIter(coords);
-    while (coordIter.hasNext())
-        if (!isFunc(coordIter.next()))
-            coordIter.remove();
+        for (int i = 0; i < rays.count[dir]; ++i)
+            coords.append(getCoord(rays.indexs[dir][i]));
+    }
 
     return coords;
 }
 
-bool SeatBase::isKingAdvCoord(const Coord& coord)
-{
-    return isKingAdvRow(coord.first) && isKingAdvCol(coord.second);
-}
-
-bool SeatBase::isBishopCoord(const Coord& coord)
-{
-    return isBishopRow(coord.first) && isCol(coord.second);
-}
-
-bool SeatBase::isValid(const Coord& coord)
-{
-    return isRow(coord.first) && isCol(coord.second);
-}
-
-bool SeatBase::isRow(int row)
-{
-    return row >= MINROWCOL && row < ROWNUM;
-}
-
-bool SeatBase::isCol(int col)
-{
-    return col >= MINROWCOL && col < COLNUM;
-}
-
-bool SeatBase::isKingAdvRow(int row)
-{
-    return ((row >= MINROWCOL && row <= KINGADVLOWMAXROW)
-        || (row >= KINGADVHIGHMINROW && row < ROWNUM));
-}
-
-bool SeatBase::isKingAdvCol(int col)
-{
-    return col >= KINGADVMINCOL && col <= KINGADVMAXCOL;
-}
-
-bool SeatBase::isBishopRow(int row)
-{
-    return BISHOPROWS.contains(row);
-}
-
 QList<Coord> getCoordList(const QList<Seat*>& seats)
 {
     QList<Coord> coords;
@@ -12,6 +12,11 @@ class BoardSeats;
 using Coord = QPair<int, int>;
 
 class Seat;
+namespace SeatTable {
+struct Steps;
+struct StepTable;
+}
+
 enum class SeatSide {
     BOTTOM,
     TOP
@@ -46,6 +51,8 @@ public:
     static const QList<QPair<Coord, QPair<PieceColor, PieceKind>>>& getInitCoordColorKinds();
 
     static QPair<Coord, Coord> coordPair(const QString& rowcols);
+    // UCCI坐标着法(如"h2e2": 列a~i, 行0~9由下至上), 格式不符时返回false
+    static bool iccsCoordPair(const QString& iccs, QPair<Coord, Coord>& coordPair);
     static bool less(Seat* first, Seat* last);
 
     // 棋子可置入位置坐标
@@ -55,6 +62,9 @@ public:
     static QList<QList<Coord>> getCanMoveCoords(Piece* piece, const Coord& coord,
         const BoardSeats* boardSeats, SeatSide homeSide);
 
+    // 步进棋子(除车、炮外)的预计算走子表
+    static const SeatTable::StepTable& getStepTable(PieceKind kind, SeatSide homeSide);
+
 private:
     static QList<Coord> getCanMove(PieceKind kind, const Coord& coord, SeatSide homeSide);
     static QList<Coord> filterMoveRule(const BoardSeats* boardSeats, PieceKind kind,
@@ -65,6 +75,8 @@ private:
         const Coord& coord, QList<Coord>& coords);
     static QList<Coord> filterKnightMoveRule(const BoardSeats* boardSeats,
         const Coord& coord, QList<Coord>& coords);
+    static QList<Coord> filterBlockMoveRule(const BoardSeats* boardSeats,
+        const SeatTable::Steps& steps, QList<Coord>& coords);
     static QList<Coord> filterRookMoveRule(const BoardSeats* boardSeats, QList<Coord>& coords);
     static QList<Coord> filterCannonMoveRule(const BoardSeats* boardSeats, QList<Coord>& coords);
 
@@ -73,24 +85,7 @@ private:
     static QList<Coord> bishopCanPut(SeatSide homeSide);
     static QList<Coord> pawnCanPut(SeatSide homeSide);
 
-    static QList<Coord> kingCanMove(int row, int col);
-    static QList<Coord> advisorCanMove(int row, int col, SeatSide homeSide);
-    static QList<Coord> bishopCanMove(int row, int col);
-    static QList<Coord> knightCanMove(int row, int col);
-    static QList<Coord> rookCannonCanMove(int fromRow, int fromCol);
-    static QList<Coord> pawnCanMove(int row, int col, SeatSide homeSide);
-
-    static QList<Coord>& filterValid(QList<Coord>& coords, bool (*isFunc)(const Coord&));
-    static bool isKingAdvCoord(const Coord& coord);
-    static bool isBishopCoord(const Coord& coord);
-
-    static bool isValid(const Coord& coord);
-    static bool isRow(int row);
-    static bool isCol(int col);
-
-    static bool isKingAdvRow(int row);
-    static bool isKingAdvCol(int col);
-    static bool isBishopRow(int row);
+    static QList<Coord> rookCannonCanMove(int index);
 };
 
 QList<Coord> getCoordList(const QList<Seat*>& seats);
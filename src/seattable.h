@@ -0,0 +1,213 @@
+#ifndef SEATTABLE_H
+#define SEATTABLE_H
+// 编译期预计算的走子表: 每个位置(及每方)的可走位置、马腿与象眼位置, 及对称变换的位置映射
+
+#include <QtGlobal>
+
+namespace SeatTable {
+
+constexpr int ROWNUM { 10 };
+constexpr int COLNUM { 9 };
+constexpr int SEATNUM { ROWNUM * COLNUM };
+constexpr int SIDENUM { 2 }; // SeatSide::BOTTOM, SeatSide::TOP
+constexpr int DIRECTIONNUM { 4 }; // 后前左右
+constexpr int NOINDEX { -1 };
+
+// 某位置的步进走法: 目标位置与对应的阻挡位置(马腿、象眼, 无则为NOINDEX)
+struct Steps {
+    int count;
+    qint8 indexs[8];
+    qint8 blockIndexs[8];
+};
+
+// 某位置的直线走法(车、炮): 按后前左右四个方向, 由近及远排列
+struct Rays {
+    int count[DIRECTIONNUM];
+    qint8 indexs[DIRECTIONNUM][ROWNUM - 1];
+};
+
+struct StepTable {
+    Steps steps[SEATNUM];
+};
+
+struct RayTable {
+    Rays rays[SEATNUM];
+};
+
+constexpr bool isValid(int row, int col)
+{
+    return row >= 0 && row < ROWNUM && col >= 0 && col < COLNUM;
+}
+
+constexpr bool isKingAdv(int row, int col)
+{
+    return ((row >= 0 && row <= 2) || (row >= 7 && row < ROWNUM)) && col >= 3 && col <= 5;
+}
+
+constexpr bool isBishopRow(int row)
+{
+    return row == 0 || row == 2 || row == 4 || row == 5 || row == 7 || row == 9;
+}
+
+constexpr void appendStep(Steps& steps, int row, int col, int blockRow = -1, int blockCol = -1)
+{
+    steps.indexs[steps.count] = qint8(row * COLNUM + col);
+    steps.blockIndexs[steps.count] = qint8(blockRow < 0 ? NOINDEX : blockRow * COLNUM + blockCol);
+    ++steps.count;
+}
+
+// 以下生成顺序与SeatBase原有的坐标列表顺序保持一致
+constexpr StepTable makeKingTable()
+{
+    StepTable table {};
+    const int steps[][2] { { 0, -1 }, { 0, 1 }, { -1, 0 }, { 1, 0 } };
+    for (int index = 0; index < SEATNUM; ++index) {
+        int row { index / COLNUM }, col { index % COLNUM };
+        for (auto& step : steps)
+            if (isKingAdv(row + step[0], col + step[1]))
+                appendStep(table.steps[index], row + step[0], col + step[1]);
+    }
+
+    return table;
+}
+
+constexpr StepTable makeAdvisorTable(int side)
+{
+    StepTable table {};
+    const int steps[][2] { { -1, -1 }, { -1, 1 }, { 1, -1 }, { 1, 1 } };
+    for (int index = 0; index < SEATNUM; ++index) {
+        int row { index / COLNUM }, col { index % COLNUM };
+        if (col != 4) {
+            appendStep(table.steps[index], side == 0 ? 1 : 8, 4);
+            continue;
+        }
+
+        for (auto& step : steps)
+            if (isValid(row + step[0], col + step[1]))
+                appendStep(table.steps[index], row + step[0], col + step[1]);
+    }
+
+    return table;
+}
+
+constexpr StepTable makeBishopTable()
+{
+    StepTable table {};
+    const int steps[][2] { { -2, -2 }, { -2, 2 }, { 2, -2 }, { 2, 2 } };
+    for (int index = 0; index < SEATNUM; ++index) {
+        int row { index / COLNUM }, col { index % COLNUM };
+        for (auto& step : steps) {
+            int toRow { row + step[0] }, toCol { col + step[1] };
+            if (isValid(toRow, toCol) && isBishopRow(toRow))
+                appendStep(table.steps[index], toRow, toCol, row + step[0] / 2, col + step[1] / 2);
+        }
+    }
+
+    return table;
+}
+
+constexpr StepTable makeKnightTable()
+{
+    StepTable table {};
+    const int steps[][2] { { -2, -1 }, { -2, 1 }, { -1, -2 }, { -1, 2 },
+        { 1, -2 }, { 1, 2 }, { 2, -1 }, { 2, 1 } };
+    for (int index = 0; index < SEATNUM; ++index) {
+        int row { index / COLNUM }, col { index % COLNUM };
+        for (auto& step : steps) {
+            int toRow { row + step[0] }, toCol { col + step[1] };
+            if (isValid(toRow, toCol))
+                appendStep(table.steps[index], toRow, toCol, row + step[0] / 2, col + step[1] / 2);
+        }
+    }
+
+    return table;
+}
+
+constexpr StepTable makePawnTable(int side)
+{
+    StepTable table {};
+    for (int index = 0; index < SEATNUM; ++index) {
+        int row { index / COLNUM }, col { index % COLNUM };
+        int toRow { row + (side == 0 ? 1 : -1) };
+        if (isValid(toRow, col))
+            appendStep(table.steps[index], toRow, col);
+
+        // 已过河
+        if ((row > 4) == (side == 0))
+            for (int toCol : { col - 1, col + 1 })
+                if (isValid(row, toCol))
+                    appendStep(table.steps[index], row, toCol);
+    }
+
+    return table;
+}
+
+constexpr RayTable makeRayTable()
+{
+    RayTable table {};
+    const int steps[][2] { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+    for (int index = 0; index < SEATNUM; ++index) {
+        int row { index / COLNUM }, col { index % COLNUM };
+        Rays& rays { table.rays[index] };
+        for (int dir = 0; dir < DIRECTIONNUM; ++dir)
+            for (int toRow = row + steps[dir][0], toCol = col + steps[dir][1];
+                 isValid(toRow, toCol); toRow += steps[dir][0], toCol += steps[dir][1])
+                rays.indexs[dir][rays.count[dir]++] = qint8(toRow * COLNUM + toCol);
+    }
+
+    return table;
+}
+
+// 由走子表反查: 可走至某位置的源位置及其阻挡位置
+constexpr StepTable makeAttackTable(const StepTable& moveTable)
+{
+    StepTable table {};
+    for (int index = 0; index < SEATNUM; ++index) {
+        const Steps& steps { moveTable.steps[index] };
+        for (int i = 0; i < steps.count; ++i) {
+            Steps& attackSteps { table.steps[steps.indexs[i]] };
+            attackSteps.indexs[attackSteps.count] = qint8(index);
+            attackSteps.blockIndexs[attackSteps.count] = steps.blockIndexs[i];
+            ++attackSteps.count;
+        }
+    }
+
+    return table;
+}
+
+// 位置变换表: 行、列是否对称后的位置序号, 各变换均为对合
+struct ChangeTable {
+    qint8 indexs[SEATNUM];
+};
+
+constexpr ChangeTable makeChangeTable(bool changeRow, bool changeCol)
+{
+    ChangeTable table {};
+    for (int index = 0; index < SEATNUM; ++index) {
+        int row { index / COLNUM }, col { index % COLNUM };
+        table.indexs[index] = qint8((changeRow ? ROWNUM - 1 - row : row) * COLNUM
+            + (changeCol ? COLNUM - 1 - col : col));
+    }
+
+    return table;
+}
+
+inline constexpr StepTable KINGTABLE { makeKingTable() };
+inline constexpr StepTable ADVISORTABLE[SIDENUM] { makeAdvisorTable(0), makeAdvisorTable(1) };
+inline constexpr StepTable BISHOPTABLE { makeBishopTable() };
+inline constexpr StepTable KNIGHTTABLE { makeKnightTable() };
+inline constexpr StepTable PAWNTABLE[SIDENUM] { makePawnTable(0), makePawnTable(1) };
+inline constexpr RayTable RAYTABLE { makeRayTable() };
+
+inline constexpr StepTable KNIGHTATTACKTABLE { makeAttackTable(KNIGHTTABLE) };
+inline constexpr StepTable PAWNATTACKTABLE[SIDENUM] { makeAttackTable(PAWNTABLE[0]),
+    makeAttackTable(PAWNTABLE[1]) };
+
+inline constexpr ChangeTable NOCHANGETABLE { makeChangeTable(false, false) };
+inline constexpr ChangeTable SYMMETRYHTABLE { makeChangeTable(false, true) };
+inline constexpr ChangeTable SYMMETRYVTABLE { makeChangeTable(true, false) };
+inline constexpr ChangeTable ROTATETABLE { makeChangeTable(true, true) };
+
+}
+
+#endif // SEATTABLE_H
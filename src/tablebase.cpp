@@ -0,0 +1,424 @@
+#include "tablebase.h"
+#include "evaluation.h"
+#include "piece.h"
+#include "position.h"
+#include "seatbase.h"
+#include "seattable.h"
+
+#include <cstring>
+
+const QString Tablebases::DEFAULTDIR { "./tablebase" };
+
+// 签名中各种类棋子的字符(按PieceKind顺序)及每方最多数量
+static const char KINDCHARS[] { 'K', 'A', 'B', 'N', 'R', 'C', 'P' };
+static const int KINDMAXNUMS[] { 1, 2, 2, 2, 2, 2, 5 };
+static const int KINDNUM { 7 };
+
+static const char FILEMAGIC[] { 'C', 'C', 'T', 'B' };
+static const quint32 FILEVERSION { 1 };
+static const int SIGNATURESIZE { 16 };
+
+// 各方各种类棋子的定义域: 位置列表, 及位置对应的定义域序号(不在域内为-1)
+struct Domains {
+    int counts[SeatTable::SIDENUM][KINDNUM];
+    qint8 seats[SeatTable::SIDENUM][KINDNUM][SeatTable::SEATNUM];
+    qint8 indexs[SeatTable::SIDENUM][KINDNUM][SeatTable::SEATNUM];
+};
+
+constexpr bool isBottomDomain(int kind, int row, int col)
+{
+    switch (kind) {
+    case 0: // 帅
+        return row <= 2 && col >= 3 && col <= 5;
+    case 1: // 仕
+        return (row == 1 && col == 4) || ((row == 0 || row == 2) && (col == 3 || col == 5));
+    case 2: // 相
+        return ((row == 0 || row == 4) && (col == 2 || col == 6))
+            || (row == 2 && (col == 0 || col == 4 || col == 8));
+    case 6: // 兵
+        return row >= 5 || ((row == 3 || row == 4) && col % 2 == 0);
+    default:
+        return true;
+    }
+}
+
+constexpr Domains makeDomains()
+{
+    Domains domains {};
+    for (int side = 0; side < SeatTable::SIDENUM; ++side)
+        for (int kind = 0; kind < KINDNUM; ++kind) {
+            for (int index = 0; index < SeatTable::SEATNUM; ++index)
+                domains.indexs[side][kind][index] = -1;
+
+            for (int index = 0; index < SeatTable::SEATNUM; ++index) {
+                // 顶方的定义域由底方中心对称而得
+                int bottomIndex { side == 0 ? index : SeatTable::SEATNUM - 1 - index };
+                if (!isBottomDomain(kind, bottomIndex / SeatTable::COLNUM, bottomIndex % SeatTable::COLNUM))
+                    continue;
+
+                int& count { domains.counts[side][kind] };
+                domains.seats[side][kind][count] = qint8(index);
+                domains.indexs[side][kind][index] = qint8(count);
+                ++count;
+            }
+        }
+
+    return domains;
+}
+
+static constexpr Domains DOMAINS { makeDomains() };
+
+static PieceColor otherColor(PieceColor color)
+{
+    return PieceColor((int(color) + 1) % 2);
+}
+
+static QString colorName(PieceColor color)
+{
+    return color == PieceColor::RED ? "红" : "黑";
+}
+
+// 解析一方签名为各种类数量, 格式错误返回false
+static bool parseSide(const QString& sideSignature, int* kindNums)
+{
+    for (int kind = 0; kind < KINDNUM; ++kind)
+        kindNums[kind] = 0;
+
+    for (QChar ch : sideSignature) {
+        int kind { 0 };
+        while (kind < KINDNUM && ch != QChar(KINDCHARS[kind]))
+            ++kind;
+        if (kind == KINDNUM || ++kindNums[kind] > KINDMAXNUMS[kind])
+            return false;
+    }
+
+    return kindNums[int(PieceKind::KING)] == 1;
+}
+
+static QString sideSignature(const int* kindNums)
+{
+    QString signature;
+    for (int kind = 0; kind < KINDNUM; ++kind)
+        signature.append(QString(kindNums[kind], QChar(KINDCHARS[kind])));
+
+    return signature;
+}
+
+static int sideValue(const int* kindNums)
+{
+    int value { 0 };
+    for (int kind = 0; kind < KINDNUM; ++kind)
+        value += kindNums[kind] * Evaluation::KINDVALUES[kind];
+
+    return value;
+}
+
+TablebaseResult TablebaseResult::fromValue(quint8 value)
+{
+    if (value == DRAWVALUE)
+        return { DRAW, 0 };
+    if (value > MAXDTM)
+        return {};
+
+    return { value % 2 == 1 ? WIN : LOSS, value };
+}
+
+QString TablebaseResult::toString(PieceColor sideColor) const
+{
+    switch (wdl) {
+    case WIN:
+        return QString("%1方胜, %2步杀").arg(colorName(sideColor)).arg((dtm + 1) / 2);
+    case LOSS:
+        return dtm == 0 ? QString("%1方负, 已无着可走").arg(colorName(sideColor))
+                        : QString("%1方负, %2步后被杀").arg(colorName(sideColor)).arg(dtm / 2);
+    case DRAW:
+        return "和棋";
+    default:
+        return {};
+    }
+}
+
+TablebaseMaterial::TablebaseMaterial(const QString& signature)
+{
+    QString normalSignature { normalize(signature) };
+    if (normalSignature.isEmpty())
+        return;
+
+    QStringList sideSignatures { normalSignature.split('v') };
+    for (int side = 0; side < SeatTable::SIDENUM; ++side) {
+        int kindNums[KINDNUM];
+        parseSide(sideSignatures.at(side), kindNums);
+        PieceColor color { side == 0 ? PieceColor::RED : PieceColor::BLACK };
+        for (int kind = 0; kind < KINDNUM; ++kind)
+            for (int i = 0; i < kindNums[kind]; ++i)
+                slots_.append({ Position::firstPieceIndex(color, PieceKind(kind)) + i, side, PieceKind(kind), 0 });
+    }
+
+    if (slots_.count() > MAXSLOTNUM) {
+        slots_.clear();
+        return;
+    }
+
+    // 走棋方占最低位, 其后各槽依次向高位排列
+    qint64 stride { 2 };
+    for (int slot = slots_.count() - 1; slot >= 0; --slot) {
+        Slot& aSlot { slots_[slot] };
+        aSlot.stride = stride;
+        stride *= DOMAINS.counts[aSlot.side][int(aSlot.kind)];
+    }
+
+    signature_ = normalSignature;
+    size_ = stride;
+}
+
+QString TablebaseMaterial::signature(const Position& position, PieceColor firstColor)
+{
+    QString sideSignatures[SeatTable::SIDENUM];
+    for (int side = 0; side < SeatTable::SIDENUM; ++side) {
+        PieceColor color { side == 0 ? firstColor : otherColor(firstColor) };
+        int kindNums[KINDNUM];
+        for (int kind = 0; kind < KINDNUM; ++kind) {
+            kindNums[kind] = 0;
+            for (int pieceIndex = Position::firstPieceIndex(color, PieceKind(kind));
+                 pieceIndex < Position::lastPieceIndex(color, PieceKind(kind)); ++pieceIndex)
+                if (position.seatIndex(pieceIndex) != Position::NOSEAT)
+                    ++kindNums[kind];
+        }
+        sideSignatures[side] = sideSignature(kindNums);
+    }
+
+    return sideSignatures[0] + 'v' + sideSignatures[1];
+}
+
+QString TablebaseMaterial::normalize(const QString& signature)
+{
+    QStringList sideSignatures { signature.split('v') };
+    if (sideSignatures.count() != SeatTable::SIDENUM)
+        return {};
+
+    int kindNums[SeatTable::SIDENUM][KINDNUM];
+    for (int side = 0; side < SeatTable::SIDENUM; ++side)
+        if (!parseSide(sideSignatures.at(side), kindNums[side]))
+            return {};
+
+    QString first { sideSignature(kindNums[0]) }, second { sideSignature(kindNums[1]) };
+    int firstValue { sideValue(kindNums[0]) }, secondValue { sideValue(kindNums[1]) };
+    if (secondValue > firstValue || (secondValue == firstValue && second > first))
+        qSwap(first, second);
+
+    return first + 'v' + second;
+}
+
+QString TablebaseMaterial::signature(const Position& position, PieceColor* firstColor)
+{
+    QString redSignature { signature(position, PieceColor::RED) };
+    QString normalSignature { normalize(redSignature) };
+    *firstColor = normalSignature == redSignature ? PieceColor::RED : PieceColor::BLACK;
+
+    return normalSignature;
+}
+
+qint64 TablebaseMaterial::index(const Position& position, PieceColor firstColor) const
+{
+    bool isRotate { position.getHomeSide(firstColor) != SeatSide::BOTTOM };
+    qint64 index { position.sideColor() == firstColor ? 0 : 1 };
+    int liveCount { 0 }, pieceIndex { 0 };
+    for (int slot = 0; slot < slots_.count(); ++slot) {
+        const Slot& aSlot { slots_.at(slot) };
+        PieceColor color { aSlot.side == 0 ? firstColor : otherColor(firstColor) };
+        // 同种棋子依次对应各槽
+        int firstIndex { Position::firstPieceIndex(color, aSlot.kind) },
+            lastIndex { Position::lastPieceIndex(color, aSlot.kind) };
+        if (slot == 0 || aSlot.kind != slots_.at(slot - 1).kind || aSlot.side != slots_.at(slot - 1).side)
+            pieceIndex = firstIndex;
+        while (pieceIndex < lastIndex && position.seatIndex(pieceIndex) == Position::NOSEAT)
+            ++pieceIndex;
+        if (pieceIndex == lastIndex)
+            return -1;
+
+        int seatIndex { position.seatIndex(pieceIndex++) };
+        if (isRotate)
+            seatIndex = SeatTable::SEATNUM - 1 - seatIndex;
+        int domainIndex { DOMAINS.indexs[aSlot.side][int(aSlot.kind)][seatIndex] };
+        if (domainIndex < 0)
+            return -1;
+
+        index += domainIndex * aSlot.stride;
+    }
+
+    // 另有不在签名中的棋子
+    for (int i = 0; i < Position::PIECENUM; ++i)
+        if (position.seatIndex(i) != Position::NOSEAT)
+            ++liveCount;
+
+    return liveCount == slots_.count() ? index : -1;
+}
+
+bool TablebaseMaterial::setPosition(qint64 index, Position& position) const
+{
+    position.clear();
+    if (position.bottomColor() != PieceColor::RED)
+        position.setBottomColor(PieceColor::RED);
+
+    for (const Slot& slot : slots_) {
+        int domainCount { DOMAINS.counts[slot.side][int(slot.kind)] };
+        int seatIndex { DOMAINS.seats[slot.side][int(slot.kind)][index / slot.stride % domainCount] };
+        if (position.hasPiece(seatIndex))
+            return false;
+
+        position.setPiece(seatIndex, slot.pieceIndex);
+    }
+    position.setSideColor(index % 2 == 0 ? PieceColor::RED : PieceColor::BLACK);
+
+    return true;
+}
+
+int TablebaseMaterial::domainIndex(int slot, int seatIndex) const
+{
+    const Slot& aSlot { slots_.at(slot) };
+    return DOMAINS.indexs[aSlot.side][int(aSlot.kind)][seatIndex];
+}
+
+QString TablebaseMaterial::captureSignature(PieceColor color, PieceKind kind, PieceColor* firstColor) const
+{
+    if (kind == PieceKind::KING)
+        return {};
+
+    QStringList sideSignatures { signature_.split('v') };
+    int side { color == PieceColor::RED ? 0 : 1 };
+    int index { sideSignatures.at(side).indexOf(QChar(KINDCHARS[int(kind)])) };
+    if (index < 0)
+        return {};
+
+    sideSignatures[side].remove(index, 1);
+    QString signature { sideSignatures.join('v') }, normalSignature { normalize(signature) };
+    *firstColor = normalSignature == signature ? PieceColor::RED : PieceColor::BLACK;
+
+    return normalSignature;
+}
+
+Tablebase::Tablebase(const QString& fileName)
+    : file_(fileName)
+{
+    if (!file_.open(QIODevice::ReadOnly) || file_.size() < HEADERSIZE)
+        return;
+
+    uchar* data { file_.map(0, file_.size()) };
+    if (!data)
+        return;
+
+    quint32 version;
+    qint64 size;
+    memcpy(&version, data + sizeof(FILEMAGIC), sizeof(version));
+    memcpy(&size, data + sizeof(FILEMAGIC) + sizeof(version), sizeof(size));
+    QString signature { QString::fromLatin1(
+        reinterpret_cast<const char*>(data) + HEADERSIZE - SIGNATURESIZE, SIGNATURESIZE) };
+    material_ = TablebaseMaterial(signature.left(signature.indexOf(QChar(0))));
+    if (memcmp(data, FILEMAGIC, sizeof(FILEMAGIC)) != 0 || version != FILEVERSION
+        || size != file_.size() - HEADERSIZE || size != material_.size()) {
+        file_.unmap(data);
+        return;
+    }
+
+    data_ = data + HEADERSIZE;
+}
+
+Tablebase::~Tablebase()
+{
+    if (data_)
+        file_.unmap(const_cast<uchar*>(data_ - HEADERSIZE));
+}
+
+bool Tablebase::write(const QString& fileName, const QString& signature, const quint8* values, qint64 size)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    char header[HEADERSIZE] {};
+    memcpy(header, FILEMAGIC, sizeof(FILEMAGIC));
+    memcpy(header + sizeof(FILEMAGIC), &FILEVERSION, sizeof(FILEVERSION));
+    memcpy(header + sizeof(FILEMAGIC) + sizeof(FILEVERSION), &size, sizeof(size));
+    QByteArray signatureBytes { signature.toLatin1().left(SIGNATURESIZE - 1) };
+    memcpy(header + HEADERSIZE - SIGNATURESIZE, signatureBytes.constData(), signatureBytes.size());
+
+    return file.write(header, HEADERSIZE) == HEADERSIZE
+        && file.write(reinterpret_cast<const char*>(values), size) == size;
+}
+
+Tablebases::Tablebases(const QString& dirName)
+    : dirName_(dirName)
+{
+}
+
+Tablebases::~Tablebases()
+{
+    qDeleteAll(tables_);
+}
+
+QString Tablebases::fileName(const QString& dirName, const QString& signature)
+{
+    return QString("%1/%2.tb").arg(dirName).arg(signature);
+}
+
+TablebaseResult Tablebases::probe(const Position& position) const
+{
+    PieceColor firstColor;
+    const Tablebase* tablebase { table(TablebaseMaterial::signature(position, &firstColor)) };
+    if (!tablebase)
+        return {};
+
+    qint64 index { tablebase->material().index(position, firstColor) };
+    return index < 0 ? TablebaseResult {} : TablebaseResult::fromValue(tablebase->value(index));
+}
+
+PackedMove Tablebases::probeMove(Position& position) const
+{
+    if (probe(position).wdl == TablebaseResult::NONE)
+        return 0;
+
+    // 以对方(走子后的走棋方)结果评分: 对方负且步数少者最优, 对方胜且步数少者最差
+    auto moveScore = [](const TablebaseResult& result) {
+        return result.wdl == TablebaseResult::LOSS ? TablebaseResult::MAXDTM * 2 - result.dtm
+            : result.wdl == TablebaseResult::WIN   ? -TablebaseResult::MAXDTM * 2 + result.dtm
+                                                   : 0;
+    };
+
+    MoveList moveList;
+    position.generateLegalMoves(position.sideColor(), moveList);
+    PackedMove bestMove { 0 };
+    int bestScore { 0 };
+    for (PackedMove move : moveList) {
+        int fromIndex { MoveList::fromIndex(move) }, toIndex { MoveList::toIndex(move) };
+        int eatPieceIndex { position.movePiece(fromIndex, toIndex) };
+        TablebaseResult result { probe(position) };
+        position.undoMovePiece(fromIndex, toIndex, eatPieceIndex);
+        if (result.wdl == TablebaseResult::NONE)
+            continue;
+
+        int score { moveScore(result) };
+        if (!bestMove || score > bestScore) {
+            bestMove = move;
+            bestScore = score;
+        }
+    }
+
+    return bestMove;
+}
+
+const Tablebase* Tablebases::table(const QString& signature) const
+{
+    if (signature.isEmpty())
+        return Q_NULLPTR;
+
+    if (!tables_.contains(signature)) {
+        Tablebase* tablebase { new Tablebase(fileName(dirName_, signature)) };
+        if (!tablebase->isValid()) {
+            delete tablebase;
+            tablebase = Q_NULLPTR;
+        }
+        tables_[signature] = tablebase;
+    }
+
+    return tables_.value(signature);
+}
@@ -0,0 +1,141 @@
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+// 残局库: 按子力组合(如"KRvKAA", 前方为强方)每种一个文件, 每个局面一字节,
+// 值为走棋方至杀棋的半回合数(DTM, 奇数为胜, 偶数为负), 或和棋、无效局面.
+// 库中局面统一以强方为红方、位于底方表示; 查询时按需交换颜色、旋转棋盘.
+// 文件只读映射(QFile::map)后直接按序号读取, 不载入内存.
+// 未计长将、长捉等循环规则, 无法在限定步数内分出胜负的局面均记为和棋.
+
+#include "movelist.h"
+
+#include <QFile>
+#include <QList>
+#include <QMap>
+#include <QString>
+
+class Position;
+enum class PieceColor;
+enum class PieceKind;
+
+// 查询结果(走棋方视角)
+struct TablebaseResult {
+    enum Wdl {
+        NONE, // 库中无此子力组合
+        LOSS,
+        DRAW,
+        WIN
+    };
+
+    static const quint8 DRAWVALUE { 0xFF };
+    static const quint8 INVALIDVALUE { 0xFE };
+    static const quint8 MAXDTM { 0xFD };
+
+    static TablebaseResult fromValue(quint8 value);
+    static bool isWinValue(quint8 value) { return value <= MAXDTM && value % 2 == 1; }
+
+    // 如"红方胜, 5步杀", sideColor为走棋方
+    QString toString(PieceColor sideColor) const;
+
+    Wdl wdl { NONE };
+    int dtm { 0 };
+};
+
+// 子力组合: 由签名确定各棋子的序号位(槽), 及每槽在其定义域内的位置
+// 定义域: 帅(将)、仕(士)、相(象)限于己方规定位置, 兵(卒)不在己方初始位置之后, 其余为全盘
+class TablebaseMaterial {
+public:
+    static const int MAXSLOTNUM { 8 };
+
+    TablebaseMaterial() = default;
+    explicit TablebaseMaterial(const QString& signature);
+
+    // 某方视为强方(前方)时的签名
+    static QString signature(const Position& position, PieceColor firstColor);
+    // 规范签名: 子力价值高者在前, 相同则字符串大者在前; 格式错误返回空串
+    static QString normalize(const QString& signature);
+    // 局面对应的规范签名及其强方颜色
+    static QString signature(const Position& position, PieceColor* firstColor);
+
+    bool isValid() const { return !slots_.isEmpty(); }
+    const QString& signature() const { return signature_; }
+    qint64 size() const { return size_; }
+
+    // 局面序号(最低位为走棋方, 0为强方走), firstColor为局面中强方的颜色;
+    // 子力不符或棋子不在定义域内时返回-1
+    qint64 index(const Position& position, PieceColor firstColor) const;
+    // 由序号还原局面(强方为红方、在底方), 棋子位置重叠时返回false
+    bool setPosition(qint64 index, Position& position) const;
+
+    // 逐槽: 棋子序号、在库中的位置序号步长, 及位置与定义域序号的互查
+    int slotCount() const { return slots_.count(); }
+    int slotPieceIndex(int slot) const { return slots_.at(slot).pieceIndex; }
+    qint64 slotStride(int slot) const { return slots_.at(slot).stride; }
+    int domainIndex(int slot, int seatIndex) const;
+
+    // 库中局面(强方为红方)吃去某方一子后的规范签名及其强方颜色, 无此子或为将帅时返回空串
+    QString captureSignature(PieceColor color, PieceKind kind, PieceColor* firstColor) const;
+
+private:
+    struct Slot {
+        int pieceIndex;
+        int side; // 0: 强方(底方), 1: 弱方(顶方)
+        PieceKind kind;
+        qint64 stride;
+    };
+
+    QString signature_ {};
+    QList<Slot> slots_ {};
+    qint64 size_ { 0 };
+};
+
+// 单个残局库文件(只读映射)
+class Tablebase {
+public:
+    explicit Tablebase(const QString& fileName);
+    ~Tablebase();
+
+    Tablebase(const Tablebase&) = delete;
+    Tablebase& operator=(const Tablebase&) = delete;
+
+    bool isValid() const { return data_; }
+    const TablebaseMaterial& material() const { return material_; }
+    const uchar* data() const { return data_; }
+    quint8 value(qint64 index) const { return data_[index]; }
+
+    // 文件: 头部(标识、版本、局面数、签名)后接每个局面一字节
+    static bool write(const QString& fileName, const QString& signature, const quint8* values, qint64 size);
+
+private:
+    static const int HEADERSIZE { 32 };
+
+    QFile file_;
+    const uchar* data_ { Q_NULLPTR };
+    TablebaseMaterial material_ {};
+};
+
+// 残局库目录: 按签名打开文件并缓存
+class Tablebases {
+public:
+    static const QString DEFAULTDIR;
+
+    explicit Tablebases(const QString& dirName = DEFAULTDIR);
+    ~Tablebases();
+
+    Tablebases(const Tablebases&) = delete;
+    Tablebases& operator=(const Tablebases&) = delete;
+
+    static QString fileName(const QString& dirName, const QString& signature);
+
+    TablebaseResult probe(const Position& position) const;
+
+    // 库中最佳着法: 能胜则最快成杀, 必负则最慢被杀, 否则保和; 库中无此局面返回0
+    PackedMove probeMove(Position& position) const;
+
+private:
+    const Tablebase* table(const QString& signature) const;
+
+    QString dirName_;
+    mutable QMap<QString, Tablebase*> tables_ {};
+};
+
+#endif // TABLEBASE_H
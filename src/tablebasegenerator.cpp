@@ -0,0 +1,265 @@
+#include "tablebasegenerator.h"
+#include "piece.h"
+#include "position.h"
+#include "seatbase.h"
+#include "seattable.h"
+
+#include <QElapsedTimer>
+#include <QThread>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+using AtomicValues = std::unique_ptr<std::atomic<quint8>[]>;
+
+static PieceColor otherColor(PieceColor color)
+{
+    return PieceColor((int(color) + 1) % 2);
+}
+
+// 按序号区间分给多个线程执行, 当前线程执行第一段
+static void parallelFor(int threadCount, qint64 size, const std::function<void(qint64, qint64)>& func)
+{
+    qint64 chunk { (size + threadCount - 1) / threadCount };
+    QList<QThread*> threads;
+    for (qint64 begin = chunk; begin < size; begin += chunk) {
+        qint64 end { qMin(begin + chunk, size) };
+        threads.append(QThread::create([&func, begin, end]() { func(begin, end); }));
+        threads.last()->start();
+    }
+
+    func(0, qMin(chunk, size));
+    for (QThread* thread : threads) {
+        thread->wait();
+        delete thread;
+    }
+}
+
+static void updateMax(std::atomic<int>& maxValue, int value)
+{
+    int oldValue { maxValue.load(std::memory_order_relaxed) };
+    while (value > oldValue && !maxValue.compare_exchange_weak(oldValue, value, std::memory_order_relaxed))
+        ;
+}
+
+// 某槽棋子反向走子的源位置: 源位置须为空且在定义域内, 马腿、象眼须为空
+static int predecessorSeats(const Position& position, PieceKind kind, int side, int seatIndex, int* seatIndexs)
+{
+    int count { 0 };
+    if (kind == PieceKind::ROOK || kind == PieceKind::CANNON) {
+        // 车、炮不吃子的走法可逆: 沿各方向至第一个棋子为止
+        const SeatTable::Rays& rays { SeatTable::RAYTABLE.rays[seatIndex] };
+        for (int dir = 0; dir < SeatTable::DIRECTIONNUM; ++dir)
+            for (int i = 0; i < rays.count[dir] && !position.hasPiece(rays.indexs[dir][i]); ++i)
+                seatIndexs[count++] = rays.indexs[dir][i];
+
+        return count;
+    }
+
+    // 马、兵(卒)用反查表(马腿在源位置一侧), 其余走法对称
+    const SeatTable::Steps& steps {
+        kind == PieceKind::KING           ? SeatTable::KINGTABLE.steps[seatIndex]
+            : kind == PieceKind::ADVISOR  ? SeatTable::ADVISORTABLE[side].steps[seatIndex]
+            : kind == PieceKind::BISHOP   ? SeatTable::BISHOPTABLE.steps[seatIndex]
+            : kind == PieceKind::KNIGHT   ? SeatTable::KNIGHTATTACKTABLE.steps[seatIndex]
+                                          : SeatTable::PAWNATTACKTABLE[side].steps[seatIndex]
+    };
+    for (int i = 0; i < steps.count; ++i) {
+        int blockIndex { steps.blockIndexs[i] };
+        if (!position.hasPiece(steps.indexs[i])
+            && (blockIndex == SeatTable::NOINDEX || !position.hasPiece(blockIndex)))
+            seatIndexs[count++] = steps.indexs[i];
+    }
+
+    return count;
+}
+
+TablebaseGenerator::TablebaseGenerator(int threadCount)
+    : threadCount_(qMax(threadCount, 1))
+{
+}
+
+bool TablebaseGenerator::generate(const QString& signature, const QString& dirName)
+{
+    TablebaseMaterial material(signature);
+    if (!material.isValid())
+        return false;
+
+    const QString& normalSignature { material.signature() };
+    if (tables_.contains(normalSignature))
+        return true;
+
+    QString fileName { Tablebases::fileName(dirName, normalSignature) };
+    Tablebase tablebase(fileName);
+    if (tablebase.isValid()) {
+        tables_[normalSignature] = QByteArray(reinterpret_cast<const char*>(tablebase.data()), material.size());
+    } else {
+        for (PieceColor color : { PieceColor::RED, PieceColor::BLACK })
+            for (int kind = int(PieceKind::ADVISOR); kind <= int(PieceKind::PAWN); ++kind) {
+                PieceColor firstColor;
+                QString subSignature { material.captureSignature(color, PieceKind(kind), &firstColor) };
+                if (!subSignature.isEmpty() && !generate(subSignature, dirName))
+                    return false;
+            }
+
+        Stats stats;
+        QByteArray values { build(material, stats) };
+        if (!Tablebase::write(fileName, normalSignature,
+                reinterpret_cast<const quint8*>(values.constData()), values.size()))
+            return false;
+
+        tables_[normalSignature] = values;
+        stats_[normalSignature] = stats;
+    }
+
+    signatures_.append(normalSignature);
+    return true;
+}
+
+QByteArray TablebaseGenerator::build(const TablebaseMaterial& material, Stats& stats) const
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // 吃子后的子库: 按被吃子[颜色][种类]
+    struct SubTable {
+        const quint8* values { Q_NULLPTR };
+        TablebaseMaterial material {};
+        PieceColor firstColor {};
+    } subTables[2][7];
+    for (PieceColor color : { PieceColor::RED, PieceColor::BLACK })
+        for (int kind = int(PieceKind::ADVISOR); kind <= int(PieceKind::PAWN); ++kind) {
+            SubTable& subTable { subTables[int(color)][kind] };
+            QString subSignature { material.captureSignature(color, PieceKind(kind), &subTable.firstColor) };
+            if (subSignature.isEmpty())
+                continue;
+
+            subTable.material = TablebaseMaterial(subSignature);
+            subTable.values = reinterpret_cast<const quint8*>(tables_[subSignature].constData());
+        }
+
+    qint64 size { material.size() };
+    AtomicValues values(new std::atomic<quint8>[size]), counts(new std::atomic<quint8>[size]);
+    // 吃子着法导致对方胜的最大DTM, 全部着法均导致对方胜时, 本局面DTM取其与反推层次的较大者加一
+    std::unique_ptr<quint8[]> maxChildValues(new quint8[size]);
+    std::atomic<int> maxValue { 0 };
+
+    parallelFor(threadCount_, size, [&](qint64 begin, qint64 end) {
+        Position position;
+        MoveList moveList;
+        int threadMaxValue { 0 };
+        for (qint64 index = begin; index < end; ++index) {
+            quint8 value { TablebaseResult::DRAWVALUE }, winValue { TablebaseResult::DRAWVALUE },
+                maxChildValue { 0 };
+            int count { 0 };
+            PieceColor color { index % 2 == 0 ? PieceColor::RED : PieceColor::BLACK };
+            if (!material.setPosition(index, position) || position.isFace()
+                || position.isKilled(otherColor(color))) {
+                values[index].store(TablebaseResult::INVALIDVALUE, std::memory_order_relaxed);
+                counts[index].store(0, std::memory_order_relaxed);
+                maxChildValues[index] = 0;
+                continue;
+            }
+
+            position.generateLegalMoves(color, moveList);
+            for (PackedMove move : moveList) {
+                int fromIndex { MoveList::fromIndex(move) }, toIndex { MoveList::toIndex(move) };
+                int eatPieceIndex { position.pieceIndex(toIndex) };
+                if (eatPieceIndex == Position::NOPIECE) {
+                    ++count;
+                    continue;
+                }
+
+                const SubTable& subTable {
+                    subTables[int(Position::color(eatPieceIndex))][int(Position::kind(eatPieceIndex))]
+                };
+                position.movePiece(fromIndex, toIndex);
+                quint8 childValue { subTable.values[subTable.material.index(position, subTable.firstColor)] };
+                position.undoMovePiece(fromIndex, toIndex, eatPieceIndex);
+                if (childValue == TablebaseResult::DRAWVALUE)
+                    ++count; // 吃子求和, 本局面不会为负
+                else if (TablebaseResult::isWinValue(childValue))
+                    maxChildValue = qMax(maxChildValue, childValue);
+                else if (childValue < TablebaseResult::MAXDTM)
+                    winValue = qMin(winValue, quint8(childValue + 1));
+            }
+
+            if (winValue != TablebaseResult::DRAWVALUE)
+                value = winValue;
+            else if (count == 0)
+                value = moveList.isEmpty() ? 0 : maxChildValue + 1;
+            if (value != TablebaseResult::DRAWVALUE)
+                threadMaxValue = qMax(threadMaxValue, int(value));
+
+            values[index].store(value, std::memory_order_relaxed);
+            counts[index].store(quint8(count), std::memory_order_relaxed);
+            maxChildValues[index] = maxChildValue;
+        }
+        updateMax(maxValue, threadMaxValue);
+    });
+
+    for (int level = 0; level <= maxValue.load() && level < TablebaseResult::MAXDTM; ++level) {
+        parallelFor(threadCount_, size, [&](qint64 begin, qint64 end) {
+            Position position;
+            int seatIndexs[SeatTable::SEATNUM];
+            for (qint64 index = begin; index < end; ++index) {
+                if (values[index].load(std::memory_order_relaxed) != level)
+                    continue;
+
+                material.setPosition(index, position);
+                int moverSide { position.sideColor() == PieceColor::RED ? 1 : 0 };
+                for (int slot = 0; slot < material.slotCount(); ++slot) {
+                    int pieceIndex { material.slotPieceIndex(slot) };
+                    if (Position::color(pieceIndex) != (moverSide == 0 ? PieceColor::RED : PieceColor::BLACK))
+                        continue;
+
+                    int seatIndex { position.seatIndex(pieceIndex) };
+                    int count { predecessorSeats(position, Position::kind(pieceIndex), moverSide, seatIndex, seatIndexs) };
+                    for (int i = 0; i < count; ++i) {
+                        int domainIndex { material.domainIndex(slot, seatIndexs[i]) };
+                        if (domainIndex < 0)
+                            continue;
+
+                        qint64 preIndex { (index ^ 1)
+                            + (domainIndex - material.domainIndex(slot, seatIndex)) * material.slotStride(slot) };
+                        quint8 preValue { values[preIndex].load(std::memory_order_relaxed) };
+                        if (preValue == TablebaseResult::INVALIDVALUE)
+                            continue;
+
+                        if (level % 2 == 0) {
+                            // 本局面为负: 前一局面走来即胜, 取较短的DTM
+                            quint8 winValue { quint8(level + 1) };
+                            while ((preValue == TablebaseResult::DRAWVALUE
+                                       || (TablebaseResult::isWinValue(preValue) && preValue > winValue))
+                                && !values[preIndex].compare_exchange_weak(preValue, winValue))
+                                ;
+                            updateMax(maxValue, winValue);
+                        } else if (preValue == TablebaseResult::DRAWVALUE
+                            && counts[preIndex].fetch_sub(1) == 1) {
+                            // 前一局面的全部着法均导致对方胜
+                            quint8 lossValue { quint8(qMax(level, int(maxChildValues[preIndex])) + 1) };
+                            values[preIndex].store(lossValue);
+                            updateMax(maxValue, lossValue);
+                        }
+                    }
+                }
+            }
+        });
+    }
+
+    QByteArray result(size, 0);
+    stats = { size, 0, 0, 0, 0, 0 };
+    for (qint64 index = 0; index < size; ++index) {
+        quint8 value { values[index].load(std::memory_order_relaxed) };
+        result[index] = char(value);
+        if (value == TablebaseResult::DRAWVALUE)
+            ++stats.draws;
+        else if (value <= TablebaseResult::MAXDTM) {
+            ++(TablebaseResult::isWinValue(value) ? stats.wins : stats.losses);
+            stats.maxDtm = qMax(stats.maxDtm, int(value));
+        }
+    }
+    stats.msecs = timer.elapsed();
+
+    return result;
+}
@@ -0,0 +1,46 @@
+#ifndef TABLEBASEGENERATOR_H
+#define TABLEBASEGENERATOR_H
+// 残局库生成(逆向分析): 先生成吃子后的各子库(目录中已有文件的直接读入).
+// 初始化: 逐局面生成着法, 无着可走为负(DTM 0); 吃子着法直接查子库, 不吃子着法计数.
+// 逐层反推: 由DTM为n的已定局面, 以反向走子(不含反吃子)求前一局面:
+// 本局面为负则前一局面为胜(n+1); 本局面为胜则前一局面未定着法数减一,
+// 减至零(全部着法均导致对方胜)即为负. 各阶段按序号区间分给多个线程, 以原子操作更新.
+
+#include "tablebase.h"
+
+#include <QByteArray>
+#include <QMap>
+#include <QStringList>
+
+class TablebaseGenerator {
+public:
+    // 单个库的统计
+    struct Stats {
+        qint64 size { 0 };
+        qint64 wins { 0 };
+        qint64 losses { 0 };
+        qint64 draws { 0 };
+        int maxDtm { 0 };
+        qint64 msecs { 0 };
+    };
+
+    explicit TablebaseGenerator(int threadCount);
+
+    // 生成签名对应的残局库及其全部子库, 新生成的写入目录
+    bool generate(const QString& signature, const QString& dirName);
+
+    // 已生成(或读入)的库数据与统计, 按生成顺序
+    const QStringList& signatures() const { return signatures_; }
+    const QByteArray& values(const QString& signature) const { return tables_[signature]; }
+    Stats stats(const QString& signature) const { return stats_.value(signature); }
+
+private:
+    QByteArray build(const TablebaseMaterial& material, Stats& stats) const;
+
+    int threadCount_;
+    QStringList signatures_ {};
+    mutable QMap<QString, QByteArray> tables_ {};
+    QMap<QString, Stats> stats_ {};
+};
+
+#endif // TABLEBASEGENERATOR_H
@@ -1,20 +1,37 @@
 #include "test.h"
+#include "annotator.h"
 #include "aspect.h"
 #include "board.h"
 #include "boardpieces.h"
 #include "boardseats.h"
 #include "database.h"
+#include "engine.h"
+#include "evaluation.h"
+#include "fencodec.h"
 #include "manual.h"
 #include "manualIO.h"
 #include "manualmove.h"
+#include "manualmoveiterator.h"
+#include "matesolver.h"
 #include "move.h"
+#include "moveorder.h"
+#include "perft.h"
 #include "piece.h"
 #include "piecebase.h"
+#include "position.h"
+#include "repetition.h"
 #include "seat.h"
 #include "seatbase.h"
+#include "tablebase.h"
+#include "tablebasegenerator.h"
 #include "tools.h"
+#include "ucciclient.h"
+#include "ucciserver.h"
+#include "zhnotation.h"
 
+#include <QCoreApplication>
 #include <QFileInfo>
+#include <QSignalSpy>
 
 static const QString outputDir { "./output" };
 
@@ -33,6 +50,14 @@ static void addFENs_data()
         QTest::newRow(fens.at(i).toUtf8()) << i << fens.at(i);
 }
 
+static void addReferenceFENs_data()
+{
+    QTest::addColumn<QString>("fen");
+
+    for (auto& reference : Perft::REFERENCES)
+        QTest::newRow(reference.fen) << QString(reference.fen);
+}
+
 static void addXqf_data()
 {
     const QList<QString> filenames = {
@@ -138,8 +163,8 @@ void TestSeat::toString()
              ChangeType::ROTATE, ChangeType::SYMMETRY_H }) {
         seats.changeLayout(&pieces, ct);
         testResult.append(seats.toString(PieceColor::RED, false))
-            .append("  RedLiveSeat:\n" + getSeatListString(pieces.getLiveSeats(PieceColor::RED)))
-            .append("\nBlackLiveSeat:\n" + getSeatListString(pieces.getLiveSeats(PieceColor::BLACK)) + "\n\n");
+            .append("  RedLiveSeat:\n" + getSeatListString(pieces.getLiveSeats(PieceColor::RED).toList()))
+            .append("\nBlackLiveSeat:\n" + getSeatListString(pieces.getLiveSeats(PieceColor::BLACK).toList()) + "\n\n");
     }
 
     QString filename { QString("%1/TestSeat_%2_%3.txt").arg(outputDir).arg(__FUNCTION__).arg(sn) };
@@ -182,6 +207,100 @@ void TestSeat::FENString()
     QCOMPARE(testResult, Tools::readTxtFile(filename));
 }
 
+void TestSeat::liveSeats_data()
+{
+    addFENs_data();
+}
+
+void TestSeat::liveSeats()
+{
+    QFETCH(QString, fen);
+
+    BoardSeats seats;
+    BoardPieces pieces;
+    seats.setFEN(&pieces, fen);
+
+    // 各种棋子的位置视图随置子、换位即时反映局面, 与局面核心一致
+    const Position& position { seats.position() };
+    for (ChangeType ct : { ChangeType::NOCHANGE, ChangeType::EXCHANGE,
+             ChangeType::ROTATE, ChangeType::SYMMETRY_H }) {
+        seats.changeLayout(&pieces, ct);
+        int liveCount { 0 };
+        for (PieceColor color : PieceBase::ALLCOLORS) {
+            for (PieceKind kind : PieceBase::ALLKINDS) {
+                int count { 0 };
+                for (Seat* seat : pieces.getLiveSeats(color, kind)) {
+                    int pieceIndex { position.pieceIndex(seat->index()) };
+                    QVERIFY(Position::color(pieceIndex) == color && Position::kind(pieceIndex) == kind);
+                    ++count;
+                }
+                QCOMPARE(pieces.getLiveSeats(color, kind).count(), count);
+                liveCount += count;
+            }
+
+            Seat* kingSeat { pieces.getKingSeat(color) };
+            QCOMPARE(kingSeat ? kingSeat->index() : Position::NOSEAT, position.kingIndex(color));
+        }
+        QCOMPARE(pieces.getLiveSeats().count(), liveCount);
+    }
+}
+
+void TestSeat::fenCodec_data()
+{
+    QTest::addColumn<QString>("fen");
+    QTest::addColumn<int>("error");
+
+    QTest::newRow("initial") << PieceBase::FENSTR << int(FenCodec::Error::NONE);
+    QTest::newRow("with side") << "5k3/9/9/9/9/9/4rp3/2R1C4/4K4/9 w - - 0 1" << int(FenCodec::Error::NONE);
+    QTest::newRow("aspect key") << "5a3/4ak2r/6R2/8p/9/9/9/B4N2B/4K4/3c5_1" << int(FenCodec::Error::NONE);
+    QTest::newRow("rotated") << "RNBAKABNR/9/1C5C1/P1P1P1P1P/9/9/p1p1p1p1p/1c5c1/9/rnbakabnr"
+                             << int(FenCodec::Error::NONE);
+    QTest::newRow("rows") << "4k4/9/9/9/9/9/9/9/4K4" << int(FenCodec::Error::ROWCOUNT);
+    QTest::newRow("cols") << "4k4/9/9/9/9/8/9/9/9/4K4" << int(FenCodec::Error::ROWLENGTH);
+    QTest::newRow("char") << "4k4/9/9/9/9/9/9/9/9/4K3X" << int(FenCodec::Error::PIECECHAR);
+    QTest::newRow("no king") << "9/9/9/9/9/9/9/9/9/4K4" << int(FenCodec::Error::PIECECOUNT);
+    QTest::newRow("cannons") << "4k4/9/9/9/9/9/9/9/CCC6/4K4" << int(FenCodec::Error::PIECECOUNT);
+    QTest::newRow("trailing split") << "4k4/9/9/9/9/9/9/9/9/5K3/" << int(FenCodec::Error::ROWCOUNT);
+    QTest::newRow("same side") << "9/9/9/9/9/9/9/4k4/9/4K4" << int(FenCodec::Error::KINGSEAT);
+    QTest::newRow("advisor") << "4k4/9/9/9/9/9/9/9/3A5/4K4" << int(FenCodec::Error::ADVISORSEAT);
+    QTest::newRow("bishop") << "4k4/9/9/9/9/9/9/9/9/3BK4" << int(FenCodec::Error::BISHOPSEAT);
+    QTest::newRow("crossed bishop") << "4k4/9/9/2B6/9/9/9/9/9/4K4" << int(FenCodec::Error::BISHOPSEAT);
+}
+
+void TestSeat::fenCodec()
+{
+    QFETCH(QString, fen);
+    QFETCH(int, error);
+
+    QChar pieChars[FenCodec::SEATNUM], fenChars[FenCodec::MAXLENGTH];
+    QCOMPARE(int(FenCodec::decode(fen.constData(), fen.size(), pieChars)), error);
+    if (error != int(FenCodec::Error::NONE)) {
+        QVERIFY(SeatBase::FENToPieChars(fen).isEmpty());
+        BoardSeats seats;
+        BoardPieces pieces;
+        QVERIFY(!seats.setFEN(&pieces, fen));
+        return;
+    }
+
+    // 编码结果与FEN的棋子字段相同, 批量解码与逐个解码一致
+    QString piecesFen { fen.left(fen.indexOf(QRegularExpression("[ _]"))) };
+    QCOMPARE(QString(fenChars, FenCodec::encode(pieChars, fenChars)), piecesFen);
+    QCOMPARE(SeatBase::pieCharsToFEN(QString(pieChars, FenCodec::SEATNUM)), piecesFen);
+
+    const QString fens[] { fen, piecesFen };
+    QChar batchChars[2 * FenCodec::SEATNUM];
+    FenCodec::Error errors[2];
+    QCOMPARE(FenCodec::decodeBatch(fens, 2, batchChars, errors), 2);
+    QCOMPARE(QString(batchChars, FenCodec::SEATNUM), QString(pieChars, FenCodec::SEATNUM));
+    QCOMPARE(QString(batchChars + FenCodec::SEATNUM, FenCodec::SEATNUM), QString(pieChars, FenCodec::SEATNUM));
+
+    BoardSeats seats;
+    BoardPieces pieces;
+    QVERIFY(seats.setFEN(&pieces, fen));
+    QCOMPARE(seats.getFEN(), piecesFen);
+    QCOMPARE(seats.getPieceChars(), QString(pieChars, FenCodec::SEATNUM));
+}
+
 void TestBoard::toString_data()
 {
     addFENs_data();
@@ -193,7 +312,7 @@ void TestBoard::toString()
     QFETCH(QString, fen);
 
     Board board {};
-    board.setFEN(fen);
+    board.setFEN(fen, PieceColor::RED);
 
     QString testResult;
     for (ChangeType ct : { ChangeType::NOCHANGE, ChangeType::EXCHANGE,
@@ -221,7 +340,7 @@ void TestBoard::canMove()
     QFETCH(QString, fen);
 
     Board board {};
-    board.setFEN(fen);
+    board.setFEN(fen, PieceColor::RED);
 
     QString testResult { board.toString() };
     for (PieceColor color : PieceBase::ALLCOLORS) {
@@ -258,6 +377,697 @@ void TestBoard::canMove()
     QCOMPARE(testResult, Tools::readTxtFile(filename));
 }
 
+void TestBoard::perft_data()
+{
+    QTest::addColumn<QString>("fen");
+    QTest::addColumn<int>("depth");
+    QTest::addColumn<quint64>("nodes");
+
+    // 深度4及以上耗时较长, 由perft工具验证
+    for (auto& reference : Perft::REFERENCES)
+        for (int depth = 1; depth <= 3; ++depth)
+            QTest::newRow(QString("%1 %2").arg(reference.fen).arg(depth).toUtf8())
+                << QString(reference.fen) << depth << reference.nodes[depth - 1];
+}
+
+void TestBoard::perft()
+{
+    QFETCH(QString, fen);
+    QFETCH(int, depth);
+    QFETCH(quint64, nodes);
+
+    Board board {};
+    PieceColor color;
+    QVERIFY(Perft::setFEN(board, fen, color));
+    QCOMPARE(Perft::perft(board.position(), color, depth), nodes);
+}
+
+void TestBoard::moveStage_data()
+{
+    addReferenceFENs_data();
+}
+
+void TestBoard::moveStage()
+{
+    QFETCH(QString, fen);
+
+    Board board {};
+    PieceColor color;
+    QVERIFY(Perft::setFEN(board, fen, color));
+    Position& position { board.position() };
+    for (PieceColor sideColor : { color, PieceColor((int(color) + 1) % 2) }) {
+        MoveList moveList, captureList, quietList;
+        position.generateLegalMoves(sideColor, moveList);
+        position.generateLegalMoves(sideColor, captureList, MoveStage::CAPTURE);
+        position.generateLegalMoves(sideColor, quietList, MoveStage::QUIET);
+
+        // 吃子、不吃子着法分别为全部着法中的吃子、不吃子部分, 次序不变
+        int captureCount { 0 }, quietCount { 0 };
+        for (PackedMove move : moveList) {
+            bool isCapture { position.hasPiece(MoveList::toIndex(move)) };
+            QVERIFY(isCapture ? captureCount < captureList.count() : quietCount < quietList.count());
+            QCOMPARE(isCapture ? captureList.at(captureCount++) : quietList.at(quietCount++), move);
+        }
+        QCOMPARE(captureCount, captureList.count());
+        QCOMPARE(quietCount, quietList.count());
+
+        // 逐个位置生成的着法合起来与整方生成一致
+        int count { 0 };
+        while (count < moveList.count()) {
+            MoveList pieceList;
+            position.generateLegalMoves(MoveList::fromIndex(moveList.at(count)), pieceList);
+            QVERIFY(!pieceList.isEmpty());
+            for (PackedMove pieceMove : pieceList) {
+                QVERIFY(count < moveList.count());
+                QCOMPARE(pieceMove, moveList.at(count++));
+            }
+        }
+    }
+}
+
+void TestBoard::gameState_data()
+{
+    QTest::addColumn<QString>("fen");
+    QTest::addColumn<int>("state");
+
+    QTest::newRow("ongoing") << PieceBase::FENSTR + " w" << int(GameState::ONGOING);
+    // 黑将被车将军, 进一步为车所控, 平中将帅对面
+    QTest::newRow("checkmate") << "3k5/9/9/9/9/9/9/9/9/3RK4 b" << int(GameState::CHECKMATE);
+    // 黑将未被将军, 但进一步为车所控, 平中将帅对面
+    QTest::newRow("stalemate") << "3k5/2R6/9/9/9/9/9/9/9/4K4 b" << int(GameState::STALEMATE);
+}
+
+void TestBoard::gameState()
+{
+    QFETCH(QString, fen);
+    QFETCH(int, state);
+
+    Board board {};
+    PieceColor color;
+    QVERIFY(Perft::setFEN(board, fen, color));
+    QCOMPARE(int(board.gameState()), state);
+    QCOMPARE(board.isFailed(color), state != int(GameState::ONGOING));
+
+    MoveList moveList;
+    board.position().generateLegalMoves(color, moveList);
+    QCOMPARE(board.position().hasAnyLegalMove(color), !moveList.isEmpty());
+}
+
+void TestBoard::hash()
+{
+    // 炮二平五、马８进７、马二进三、炮８平５, 两种次序到达同一局面
+    const QList<QPair<Coord, Coord>> coordPairs {
+        { { 2, 7 }, { 2, 4 } }, { { 9, 7 }, { 7, 6 } },
+        { { 0, 7 }, { 2, 6 } }, { { 7, 7 }, { 7, 4 } }
+    };
+    const QList<QList<int>> orders { { 0, 1, 2, 3 }, { 2, 1, 0, 3 } };
+
+    QList<quint64> hashs;
+    for (auto& order : orders) {
+        Board board {};
+        Position& position { board.position() };
+        quint64 startHash { board.hash() };
+        for (int index : order) {
+            const auto& coordPair = coordPairs.at(index);
+            position.movePiece(SeatBase::getIndex(coordPair.first), SeatBase::getIndex(coordPair.second));
+        }
+        hashs.append(board.hash());
+
+        for (int i = order.count() - 1; i >= 0; --i) {
+            const auto& coordPair = coordPairs.at(order.at(i));
+            position.undoMovePiece(SeatBase::getIndex(coordPair.first),
+                SeatBase::getIndex(coordPair.second), Position::NOPIECE);
+        }
+        QCOMPARE(board.hash(), startHash);
+    }
+    QCOMPARE(hashs.at(0), hashs.at(1));
+
+    // 增量更新与直接设置局面一致, 走棋方不同则键值不同
+    const QString fen { "rnbakab1r/9/1c2c1n2/p1p1p1p1p/9/9/P1P1P1P1P/1C2C1N2/9/RNBAKAB1R" };
+    Board board {};
+    board.setFEN(fen, PieceColor::RED);
+    QCOMPARE(board.hash(), hashs.at(0));
+    board.setFEN(fen, PieceColor::BLACK);
+    QVERIFY(board.hash() != hashs.at(0));
+
+    // 左右对称两次后还原
+    quint64 hash { board.hash() };
+    board.changeLayout(ChangeType::SYMMETRY_H);
+    QVERIFY(board.hash() != hash);
+    board.changeLayout(ChangeType::SYMMETRY_H);
+    QCOMPARE(board.hash(), hash);
+}
+
+void TestBoard::canonicalKey_data()
+{
+    addFENs_data();
+}
+
+void TestBoard::canonicalKey()
+{
+    QFETCH(QString, fen);
+
+    Board board {};
+    board.setFEN(fen, PieceColor::RED);
+    const CanonicalKey canonicalKey { board.canonicalKey() };
+
+    // 按所施变换重建的局面, 其键即规范键; 着法经两次变换还原
+    const Position& position { board.position() };
+    const SymmetryTransform& transform { canonicalKey.transform };
+    Position transformed {};
+    for (int pieceIndex = 0; pieceIndex < Position::PIECENUM; ++pieceIndex) {
+        int index { position.seatIndex(pieceIndex) };
+        if (index != Position::NOSEAT)
+            transformed.setPiece(transform.seatIndex(index),
+                transform.exchange ? (pieceIndex + Position::COLORPIECENUM) % Position::PIECENUM : pieceIndex);
+    }
+    transformed.setSideColor(transform.color(position.sideColor()));
+    QCOMPARE(transformed.hash(), canonicalKey.key);
+    PackedMove move { MoveList::pack(SeatBase::getIndex({ 0, 1 }), SeatBase::getIndex({ 2, 2 })) };
+    QCOMPARE(transform.move(transform.move(move)), move);
+
+    // 左右对称、旋转(底方改变)、对换颜色(走棋方随之改变)后, 规范键不变
+    for (ChangeType ct : { ChangeType::SYMMETRY_H, ChangeType::ROTATE, ChangeType::EXCHANGE,
+             ChangeType::SYMMETRY_H, ChangeType::ROTATE }) {
+        board.changeLayout(ct);
+        QCOMPARE(board.canonicalKey().key, canonicalKey.key);
+    }
+}
+
+void TestBoard::snapshot_data()
+{
+    addFENs_data();
+}
+
+void TestBoard::snapshot()
+{
+    QFETCH(QString, fen);
+
+    Board board {};
+    board.setFEN(fen, PieceColor::RED);
+    const quint64 hash { board.hash() };
+    const QString boardFen { board.getFEN() };
+
+    // 副本上按压缩着法走子, 棋盘不受影响
+    Position position { board.snapshot() };
+    QList<QPair<PackedMove, int>> moves;
+    for (int ply = 0; ply < 6; ++ply) {
+        MoveList moveList;
+        position.generateLegalMoves(position.sideColor(), moveList);
+        if (moveList.isEmpty())
+            break;
+
+        PackedMove move { moveList.at(moveList.count() / 2) };
+        QVERIFY(position.isLegalMove(move));
+        moves.append({ move, position.makeMove(move) });
+    }
+    QCOMPARE(board.hash(), hash);
+    QVERIFY(moves.isEmpty() || !position.isLegalMove(moves.last().first));
+
+    // 按副本重置另一棋盘, 局面一致; 撤销后与原局面一致
+    Board other {};
+    other.restore(position);
+    QCOMPARE(other.hash(), position.hash());
+    QCOMPARE(other.position().sideColor(), position.sideColor());
+    for (int i = moves.count() - 1; i >= 0; --i)
+        position.undoMove(moves.at(i).first, moves.at(i).second);
+    other.restore(position);
+    QCOMPARE(other.hash(), hash);
+    QCOMPARE(other.getFEN(), boardFen);
+}
+
+void TestBoard::bitboard_data()
+{
+    addFENs_data();
+}
+
+void TestBoard::bitboard()
+{
+#ifndef CCHESS_BITBOARD
+    QSKIP("未启用位棋盘后端(CONFIG+=bitboard)");
+#else
+    QFETCH(QString, fen);
+
+    Board board {};
+    board.setFEN(fen, PieceColor::RED);
+    const Position& position { board.position() };
+    for (PieceColor color : { PieceColor::RED, PieceColor::BLACK }) {
+        // 各种棋子位置与逐个棋子所在位置一致
+        int bitsCount { 0 }, pieceCount { 0 };
+        for (int kind = 0; kind < 7; ++kind) {
+            Bitboard bits { position.pieceBits(color, PieceKind(kind)) };
+            bitsCount += bits.count();
+            while (!bits.isEmpty()) {
+                int pieceIndex { position.pieceIndex(bits.takeFirst()) };
+                QVERIFY(pieceIndex != Position::NOPIECE);
+                QCOMPARE(Position::color(pieceIndex), color);
+                QCOMPARE(Position::kind(pieceIndex), PieceKind(kind));
+            }
+        }
+        for (int index = 0; index < SeatTable::SEATNUM; ++index)
+            if (position.hasPiece(index) && Position::color(position.pieceIndex(index)) == color)
+                ++pieceCount;
+        QCOMPARE(bitsCount, pieceCount);
+
+        // 九宫内攻击位置与逐个位置判断一致
+        Bitboard attacks { position.attackBits(color) };
+        for (int row = 0; row < SeatTable::ROWNUM; ++row)
+            for (int col = 0; col < SeatTable::COLNUM; ++col) {
+                int index { row * SeatTable::COLNUM + col };
+                if (SeatTable::isKingAdv(row, col))
+                    QCOMPARE(attacks.test(index), position.isSeatAttacked(index, color));
+            }
+    }
+#endif
+}
+
+void TestBoard::zhNotation_data()
+{
+    addReferenceFENs_data();
+}
+
+void TestBoard::zhNotation()
+{
+    QFETCH(QString, fen);
+
+    Board board {};
+    PieceColor color;
+    QVERIFY(Perft::setFEN(board, fen, color));
+
+    // 每个合法着法编码后解码还原, 且各着法的中文着法互不相同
+    MoveList moveList;
+    Position& position { board.position() };
+    position.generateLegalMoves(color, moveList);
+    QStringList zhStrs;
+    for (PackedMove move : moveList) {
+        SeatPair seatPair { board.getSeatPair({ SeatBase::getCoord(MoveList::fromIndex(move)),
+            SeatBase::getCoord(MoveList::toIndex(move)) }) };
+        QString zhStr { board.getZhStr(seatPair) };
+        QCOMPARE(board.getSeatPair(zhStr), seatPair);
+        QVERIFY(!zhStrs.contains(zhStr));
+        zhStrs.append(zhStr);
+    }
+
+    // 批量: 沿各步第一个合法着法走若干步再撤销, 整列编码、解码后局面不变
+    const int count { 16 };
+    PackedMove moves[count], decodeMoves[count];
+    int eatPieceIndexs[count];
+    int moveCount { 0 };
+    for (; moveCount < count; ++moveCount) {
+        MoveList stepMoves;
+        position.generateLegalMoves(position.sideColor(), stepMoves);
+        if (stepMoves.isEmpty())
+            break;
+
+        moves[moveCount] = stepMoves.at(0);
+        eatPieceIndexs[moveCount]
+            = position.movePiece(MoveList::fromIndex(moves[moveCount]), MoveList::toIndex(moves[moveCount]));
+    }
+    for (int index = moveCount - 1; index >= 0; --index)
+        position.undoMovePiece(MoveList::fromIndex(moves[index]), MoveList::toIndex(moves[index]),
+            eatPieceIndexs[index]);
+
+    quint64 hash { board.hash() };
+    QChar zhChars[count * ZhNotation::ZHLENGTH];
+    QCOMPARE(ZhNotation::encodeMoves(position, moves, moveCount, zhChars), moveCount);
+    QCOMPARE(ZhNotation::decodeMoves(position, zhChars, moveCount, decodeMoves), moveCount);
+    QCOMPARE(board.hash(), hash);
+    for (int index = 0; index < moveCount; ++index)
+        QCOMPARE(decodeMoves[index], moves[index]);
+}
+
+void TestBoard::zhNotationCases_data()
+{
+    QTest::addColumn<QString>("fen");
+    QTest::addColumn<QString>("rowcols");
+    QTest::addColumn<QString>("zhStr");
+
+    // 已知着法的固定用例, 防止编码、解码同样出错而往返检验仍能通过
+    const QString startFEN { PieceBase::FENSTR + " w" };
+    const QString rooksFEN { "5k3/9/9/9/9/9/4R4/9/4R4/3K5 w" };
+    const QString pawnsFEN { "3k5/9/6P2/5PP2/5P3/9/9/9/9/4K4 w" };
+    QTest::newRow("炮二平五") << startFEN << "2724" << "炮二平五";
+    QTest::newRow("马二进三") << startFEN << "0726" << "马二进三";
+    QTest::newRow("炮８平５") << PieceBase::FENSTR + " b" << "7774" << "炮８平５";
+    QTest::newRow("前车进一") << rooksFEN << "3444" << "前车进一";
+    QTest::newRow("后车进一") << rooksFEN << "1424" << "后车进一";
+    QTest::newRow("一兵平四") << pawnsFEN << "7675" << "一兵平四";
+    QTest::newRow("三兵进一") << pawnsFEN << "6575" << "三兵进一";
+}
+
+void TestBoard::zhNotationCases()
+{
+    QFETCH(QString, fen);
+    QFETCH(QString, rowcols);
+    QFETCH(QString, zhStr);
+
+    Board board {};
+    PieceColor color;
+    QVERIFY(Perft::setFEN(board, fen, color));
+
+    SeatPair seatPair { board.getSeatPair(SeatBase::coordPair(rowcols)) };
+    QCOMPARE(board.getZhStr(seatPair), zhStr);
+    QCOMPARE(board.getSeatPair(zhStr), seatPair);
+}
+
+void TestEngine::table()
+{
+    TranspositionTable table(1);
+    QCOMPARE(table.megabytes(), 1);
+
+    quint64 hash { 0x123456789ABCDEF0ULL };
+    TableEntry entry;
+    QVERIFY(!table.probe(hash, entry));
+
+    table.store(hash, MoveList::pack(10, 19), -29990, 7, Bound::LOWER);
+    QVERIFY(table.probe(hash, entry));
+    QCOMPARE(entry.move, MoveList::pack(10, 19));
+    QCOMPARE(entry.score, -29990);
+    QCOMPARE(entry.depth, 7);
+    QCOMPARE(entry.bound, Bound::LOWER);
+
+    // 同桶不同键不命中; 清空后不命中
+    QVERIFY(!table.probe(hash ^ (1ULL << 63), entry));
+    table.clear();
+    QVERIFY(!table.probe(hash, entry));
+}
+
+void TestEngine::evaluate_data()
+{
+    addFENs_data();
+}
+
+void TestEngine::evaluate()
+{
+    QFETCH(QString, fen);
+
+    Board board {};
+    board.setFEN(fen, PieceColor::RED);
+    int value { Evaluation::evaluate(board.position(), PieceColor::RED) };
+    QCOMPARE(Evaluation::evaluate(board.position(), PieceColor::BLACK), -value);
+    if (fen == PieceBase::FENSTR)
+        QCOMPARE(value, 0);
+
+    // 左右对称、旋转不改变评价, 对换颜色则评价反号
+    board.changeLayout(ChangeType::SYMMETRY_H);
+    QCOMPARE(Evaluation::evaluate(board.position(), PieceColor::RED), value);
+    board.changeLayout(ChangeType::ROTATE);
+    QCOMPARE(Evaluation::evaluate(board.position(), PieceColor::RED), value);
+    board.changeLayout(ChangeType::EXCHANGE);
+    QCOMPARE(Evaluation::evaluate(board.position(), PieceColor::RED), -value);
+}
+
+void TestEngine::moveOrder()
+{
+    MoveOrder moveOrder;
+    // 吃子在前, 且被吃子价值不升
+    for (auto& reference : Perft::REFERENCES) {
+        Board board {};
+        PieceColor color;
+        QVERIFY(Perft::setFEN(board, reference.fen, color));
+        Position& position { board.position() };
+        MoveList moveList;
+        position.generateLegalMoves(color, moveList);
+        moveOrder.sort(position, moveList, 0, 0, 0);
+        int lastValue { Evaluation::KINDVALUES[int(PieceKind::ROOK)] };
+        bool isQuiet { false };
+        for (PackedMove move : moveList) {
+            int eatPieceIndex { position.pieceIndex(MoveList::toIndex(move)) };
+            if (eatPieceIndex == Position::NOPIECE) {
+                isQuiet = true;
+                continue;
+            }
+            QVERIFY(!isQuiet);
+            int value { Evaluation::KINDVALUES[int(Position::kind(eatPieceIndex))] };
+            QVERIFY(value <= lastValue);
+            lastValue = value;
+        }
+    }
+
+    // 截断的不吃子着法成为杀手及反击着法, 排在吃子之后、其余不吃子之前
+    Board board {};
+    PieceColor color;
+    QVERIFY(Perft::setFEN(board, PieceBase::FENSTR, color));
+    Position& position { board.position() };
+    PackedMove prevMove { MoveList::pack(64, 67) }, move { MoveList::pack(1, 20) };
+    moveOrder.updateCutoff(position, move, 0, 4, prevMove, &move, 1);
+    QCOMPARE(moveOrder.killer(0, 0), move);
+    QCOMPARE(moveOrder.counterMove(prevMove), move);
+    QVERIFY(moveOrder.history(move) > 0);
+
+    MoveList moveList;
+    position.generateLegalMoves(color, moveList);
+    moveOrder.sort(position, moveList, 0, 0, 0);
+    QCOMPARE(moveList.at(2), move); // 双炮打马两个吃子着法在前
+    moveOrder.sort(position, moveList, 1, moveList.at(10), prevMove);
+    QCOMPARE(moveList.at(3), move); // 另一层: 指定着法、吃子之后为反击着法
+
+    moveOrder.recordCutoff(1);
+    moveOrder.recordCutoff(3);
+    QCOMPARE(moveOrder.stats().firstMoveCutRate(), 50.0);
+    QCOMPARE(moveOrder.stats().averageCutIndex(), 2.0);
+}
+
+void TestEngine::repetition_data()
+{
+    QTest::addColumn<QString>("fen");
+    QTest::addColumn<QString>("moves"); // 起止位置序号
+    QTest::addColumn<int>("kind");
+
+    QTest::newRow("idle") << "3k5/9/9/9/9/9/9/9/9/4K4 w"
+                          << "4 13 84 75 13 4 75 84" << int(RepetitionKind::IDLE);
+    QTest::newRow("check") << "4k4/9/9/9/9/9/9/9/R8/3K5 w"
+                           << "9 81 85 76 81 72 76 85 72 81" << int(RepetitionKind::PERPETUAL_CHECK);
+    QTest::newRow("chase") << "4k4/9/9/r8/9/9/1N7/9/9/3K5 w"
+                           << "28 37 54 45 37 28 45 54" << int(RepetitionKind::PERPETUAL_CHASE);
+}
+
+void TestEngine::repetition()
+{
+    QFETCH(QString, fen);
+    QFETCH(QString, moves);
+    QFETCH(int, kind);
+
+    Board board {};
+    PieceColor color;
+    QVERIFY(Perft::setFEN(board, fen, color));
+    Position& position { board.position() };
+    RepetitionHistory history;
+    QStringList indexs { moves.split(' ') };
+    for (int i = 0; i < indexs.count(); i += 2) {
+        // 最后一着之前不重复
+        QCOMPARE(history.check(position).kind, RepetitionKind::NONE);
+        int fromIndex { indexs.at(i).toInt() }, toIndex { indexs.at(i + 1).toInt() };
+        history.push(position.hash(), MoveList::pack(fromIndex, toIndex), position.hasPiece(toIndex));
+        position.movePiece(fromIndex, toIndex);
+    }
+
+    Repetition repetition { history.check(position) };
+    QCOMPARE(int(repetition.kind), kind);
+    if (repetition.kind != RepetitionKind::IDLE)
+        QCOMPARE(repetition.loseColor, PieceColor::RED);
+}
+
+void TestEngine::tablebase_data()
+{
+    QTest::addColumn<QString>("fen");
+    QTest::addColumn<int>("wdl");
+    QTest::addColumn<int>("dtm");
+
+    // 单车对光将: 走一步即困毙; 黑方走则必负; 黑将吃去无根车则和
+    QTest::newRow("win") << "4k4/9/9/9/9/9/9/9/9/3K1R3 w" << int(TablebaseResult::WIN) << 1;
+    QTest::newRow("loss") << "4k4/9/9/9/9/9/9/9/9/3K1R3 b" << int(TablebaseResult::LOSS) << 4;
+    QTest::newRow("draw") << "4k4/4R4/9/9/9/9/9/9/9/3K5 b" << int(TablebaseResult::DRAW) << 0;
+    QTest::newRow("none") << PieceBase::FENSTR + " w" << int(TablebaseResult::NONE) << 0;
+}
+
+void TestEngine::tablebase()
+{
+    QFETCH(QString, fen);
+    QFETCH(int, wdl);
+    QFETCH(int, dtm);
+
+    QString dirName { outputDir + "/tablebase" };
+    QDir().mkpath(dirName);
+    TablebaseGenerator generator(2);
+    QVERIFY(generator.generate("KRvK", dirName));
+    QCOMPARE(generator.signatures().last(), QString("KRvK"));
+    // 文件与生成数据一致
+    Tablebase file(Tablebases::fileName(dirName, "KRvK"));
+    QVERIFY(file.isValid());
+    QCOMPARE(QByteArray(reinterpret_cast<const char*>(file.data()), file.material().size()),
+        generator.values("KRvK"));
+
+    Board board {};
+    PieceColor color;
+    QVERIFY(Perft::setFEN(board, fen, color));
+    Tablebases tablebases(dirName);
+    TablebaseResult result { tablebases.probe(board.position()) };
+    QCOMPARE(int(result.wdl), wdl);
+    QCOMPARE(result.dtm, dtm);
+    if (result.wdl != TablebaseResult::NONE)
+        QVERIFY(tablebases.probeMove(board.position()) != 0);
+}
+
+void TestEngine::mateSolve_data()
+{
+    QTest::addColumn<QString>("fen");
+    QTest::addColumn<bool>("checksOnly");
+    QTest::addColumn<int>("status");
+
+    QTest::newRow("double rooks") << "3k5/9/9/9/9/9/9/9/R8/1R2K4 w" << true << int(MateResult::PROVEN);
+    QTest::newRow("quiet moves") << "3ak4/9/4b4/9/9/9/9/9/4R4/3K5 w" << false << int(MateResult::PROVEN);
+    QTest::newRow("no checks") << "3ak4/9/4b4/9/9/9/9/9/4R4/3K5 w" << true << int(MateResult::DISPROVEN);
+    QTest::newRow("bare kings") << "4k4/9/9/9/9/9/9/9/9/4K4 w" << false << int(MateResult::DISPROVEN);
+}
+
+void TestEngine::mateSolve()
+{
+    QFETCH(QString, fen);
+    QFETCH(bool, checksOnly);
+    QFETCH(int, status);
+
+    Manual manual;
+    PieceColor color;
+    QVERIFY(Perft::setFEN(*manual.board(), fen, color));
+    MateLimits limits;
+    limits.nodes = 1000000;
+    limits.checksOnly = checksOnly;
+    MateSolver solver(manual.board()->position(), limits);
+    MateResult result { solver.solve() };
+    QCOMPARE(int(result.status), status);
+    QVERIFY(result.nodes > 0);
+    if (result.status != MateResult::PROVEN)
+        return;
+
+    // 解答树全部追加为着法, 末着均为杀
+    QVERIFY(!result.solution.isEmpty() && result.length % 2 == 1);
+    QVERIFY(manual.appendMateSolution(result));
+    QCOMPARE(manual.manualMove()->getMovCount(), result.solution.count());
+    QList<Move*> endMoves;
+    ManualMoveFirstNextIterator firstNextIter(manual.manualMove());
+    while (firstNextIter.hasNext()) {
+        Move* move = firstNextIter.next();
+        if (!move->hasNext())
+            endMoves.append(move);
+    }
+    for (Move* move : endMoves) {
+        manual.manualMove()->goTo(move);
+        QCOMPARE(move->color(), color);
+        QVERIFY(manual.board()->isFailed(color == PieceColor::RED ? PieceColor::BLACK : PieceColor::RED));
+    }
+}
+
+void TestEngine::search_data()
+{
+    QTest::addColumn<QString>("fen");
+    QTest::addColumn<int>("depth");
+
+    // 红先, 限定深度内可杀
+    QTest::newRow("mate 3") << "4k4/9/9/9/9/9/9/9/4A4/3KR4 w" << 4;
+    QTest::newRow("mate 9") << "3ak4/9/4b4/9/9/9/9/9/4R4/3K5 w" << 10;
+}
+
+void TestEngine::search()
+{
+    QFETCH(QString, fen);
+    QFETCH(int, depth);
+
+    Board board {};
+    PieceColor color;
+    QVERIFY(Perft::setFEN(board, fen, color));
+
+    TranspositionTable table(1);
+    Engine engine(board.position(), &table);
+    SearchResult result { engine.search({ depth, 0 }) };
+    QVERIFY(Engine::isMateScore(result.score) && result.score > 0);
+    QVERIFY(!result.pv.isEmpty() && result.pv.first() == result.bestMove);
+    QVERIFY(board.canMove(board.getSeatPair({ SeatBase::getCoord(MoveList::fromIndex(result.bestMove)),
+        SeatBase::getCoord(MoveList::toIndex(result.bestMove)) })));
+
+    // 第一次迭代即被中止: 不作为已完成的深度, 仍给出合法着法
+    result = engine.search({ 0, 0, 1 });
+    QCOMPARE(result.depth, 0);
+    QVERIFY(result.pv.isEmpty());
+    QVERIFY(board.canMove(board.getSeatPair({ SeatBase::getCoord(MoveList::fromIndex(result.bestMove)),
+        SeatBase::getCoord(MoveList::toIndex(result.bestMove)) })));
+
+    // 从深度2开始的辅助线程, 限定深度为1时仍完成深度1
+    Engine helper(board.position(), &table);
+    helper.setThreadIndex(1);
+    QCOMPARE(helper.search({ 1, 0 }).depth, 1);
+}
+
+void TestEngine::ucci()
+{
+    QStringList output;
+    UcciServer server([&output](const QString& line) { output.append(line); });
+    QVERIFY(server.execute("ucci"));
+    QCOMPARE(output.last(), QString("ucciok"));
+
+    // 着法列表延长时只执行新增的着法, 改变时只撤销、执行不同的后段
+    QVERIFY(server.execute("position startpos moves h2e2 h9g7"));
+    QCOMPARE(server.appliedCount(), 2);
+    QVERIFY(server.execute("position startpos moves h2e2 h9g7 h0g2"));
+    QCOMPARE(server.undoneCount(), 0);
+    QCOMPARE(server.appliedCount(), 1);
+    QVERIFY(server.execute("position fen " + PieceBase::FENSTR + " w - - 0 1 moves h2e2 h7e7"));
+    QCOMPARE(server.undoneCount(), 2);
+    QCOMPARE(server.appliedCount(), 1);
+
+    UcciServer replay([](const QString&) {});
+    QVERIFY(replay.execute("position startpos moves h2e2 h7e7"));
+    QCOMPARE(replay.appliedCount(), 2);
+    QCOMPARE(server.hash(), replay.hash());
+
+    QVERIFY(server.execute("go depth 3"));
+    server.wait();
+    QVERIFY(output.last().startsWith("bestmove "));
+    QVERIFY(!server.execute("quit"));
+    QCOMPARE(output.last(), QString("bye"));
+}
+
+void TestEngine::ucciClient()
+{
+    // 以本程序的--ucci模式作为外部引擎
+    qRegisterMetaType<UcciInfo>();
+    UcciClient client;
+    QSignalSpy readySpy(&client, &UcciClient::ready);
+    QSignalSpy infoSpy(&client, &UcciClient::infoReceived);
+    QSignalSpy bestMoveSpy(&client, &UcciClient::bestMoveReceived);
+    client.start(QCoreApplication::applicationFilePath(), { "--ucci", "-j", "1" });
+    QVERIFY(readySpy.wait(5000));
+
+    client.analyze(PieceBase::FENSTR, PieceColor::RED);
+    QVERIFY(infoSpy.wait(5000));
+    UcciInfo info { infoSpy.last().first().value<UcciInfo>() };
+    QVERIFY(!info.zhPv.isEmpty() && info.zhPv.count() <= info.pv.count());
+
+    // 分析中改变局面: 旧搜索中止, 其bestmove不发出; 新局面有杀着, 搜索自行结束
+    client.analyze("3k5/9/9/9/9/9/9/9/R8/1R2K4", PieceColor::RED);
+    QTRY_COMPARE_WITH_TIMEOUT(bestMoveSpy.count(), 1, 10000);
+    QCOMPARE(client.state(), UcciClient::State::IDLE);
+    QVERIFY(!bestMoveSpy.first().at(1).toString().isEmpty());
+
+    // 黑方在下的局面: 引擎坐标着法按红方在下解读, 须为原局面的合法着法, 中文着法与之一致
+    const QString mateFEN { "3k5/9/9/9/9/9/9/9/R8/1R2K4" };
+    Board board {}, rotateBoard {};
+    QVERIFY(board.setFEN(mateFEN, PieceColor::RED));
+    QVERIFY(rotateBoard.setFEN(mateFEN, PieceColor::RED));
+    QVERIFY(rotateBoard.changeLayout(ChangeType::ROTATE));
+    QCOMPARE(rotateBoard.position().bottomColor(), PieceColor::BLACK);
+    client.analyze(rotateBoard.getFEN(), PieceColor::RED);
+    QTRY_COMPARE_WITH_TIMEOUT(bestMoveSpy.count(), 2, 10000);
+    QPair<Coord, Coord> coordPair;
+    QVERIFY(SeatBase::iccsCoordPair(bestMoveSpy.last().at(0).toString(), coordPair));
+    QVERIFY(board.position().isLegalMove(
+        MoveList::pack(SeatBase::getIndex(coordPair.first), SeatBase::getIndex(coordPair.second))));
+    QCOMPARE(bestMoveSpy.last().at(1).toString(), board.getZhStr(board.getSeatPair(coordPair)));
+
+    client.quit();
+    QCOMPARE(client.state(), UcciClient::State::NOTSTARTED);
+}
+
 void TestManual::toString_data()
 {
     addXqf_data();
@@ -325,6 +1135,40 @@ void TestManual::toReadWriteFile()
     //    delete manual;
 }
 
+void TestManual::annotate_data()
+{
+    addXqf_data();
+}
+
+void TestManual::annotate()
+{
+    QFETCH(int, sn);
+    QFETCH(QString, xqfFileName);
+
+    Q_UNUSED(sn)
+    Manual manual(xqfFileName);
+    QStringList remarks;
+    ManualMoveFirstNextIterator remarkIter(manual.manualMove());
+    while (remarkIter.hasNext())
+        remarks.append(remarkIter.next()->remark());
+
+    // 再次批注时替换旧批注, 原有注释不变
+    Annotator annotator({ 2, 0 }, 2);
+    int count { annotator.annotate(&manual) };
+    QCOMPARE(count, remarks.count());
+    QCOMPARE(annotator.annotate(&manual), count);
+    QCOMPARE(annotator.stats().positions, count * 2);
+
+    int index { 0 };
+    ManualMoveFirstNextIterator firstNextIter(manual.manualMove());
+    while (firstNextIter.hasNext()) {
+        QString remark { firstNextIter.next()->remark() };
+        QCOMPARE(remark.count("〔评分: "), 1);
+        QVERIFY(remark.endsWith("〕"));
+        QCOMPARE(Annotator::removeAnnotation(remark), remarks.at(index++));
+    }
+}
+
 void TestManual::toReadWriteDir_data()
 {
     addXqfDir_data();
@@ -480,3 +1324,32 @@ void TestInitEcco::initEcco()
     //    dataBase.setRowcolsXqbaseManual(false);
     //    dataBase.checkEccosnXqbaseManual(true);
 }
+
+void TestInitEcco::setRowcols_data()
+{
+    QTest::addColumn<QString>("fen");
+    QTest::addColumn<QString>("moveStr");
+
+    QTest::newRow("red first") << PieceBase::FENSTR + " r - - 0 1"
+                               << "1. 炮二平五 马８进７ 2. 马二进三 车９平８";
+    QTest::newRow("black first") << PieceBase::FENSTR + " b - - 0 1"
+                                 << "1. 炮８平５ 炮二平五 2. 马８进７ 马二进三";
+}
+
+void TestInitEcco::setRowcols()
+{
+    QFETCH(QString, fen);
+    QFETCH(QString, moveStr);
+
+    // 初始局面的快速解码与构造完整棋谱所得一致
+    InfoMap infoMap {
+        { ManualIO::getInfoName(InfoIndex::FEN), fen },
+        { ManualIO::getInfoName(InfoIndex::MOVESTR), moveStr }
+    };
+    Manual manual(infoMap);
+    QString rowcols { manual.getECCORowcols() };
+    QVERIFY(!rowcols.isEmpty());
+
+    DataBase::setRowcols(infoMap);
+    QCOMPARE(infoMap.value(ManualIO::getInfoName(InfoIndex::ROWCOLS)), rowcols);
+}
@@ -21,6 +21,12 @@ private slots:
 
     void FENString_data();
     void FENString();
+
+    void liveSeats_data();
+    void liveSeats();
+
+    void fenCodec_data();
+    void fenCodec();
 };
 
 class TestBoard : public QObject {
@@ -31,6 +37,58 @@ private slots:
 
     void canMove_data();
     void canMove();
+
+    void perft_data();
+    void perft();
+
+    void moveStage_data();
+    void moveStage();
+
+    void gameState_data();
+    void gameState();
+
+    void hash();
+
+    void canonicalKey_data();
+    void canonicalKey();
+
+    void snapshot_data();
+    void snapshot();
+
+    void bitboard_data();
+    void bitboard();
+
+    void zhNotation_data();
+    void zhNotation();
+
+    void zhNotationCases_data();
+    void zhNotationCases();
+};
+
+class TestEngine : public QObject {
+    Q_OBJECT
+private slots:
+    void table();
+
+    void evaluate_data();
+    void evaluate();
+
+    void moveOrder();
+
+    void repetition_data();
+    void repetition();
+
+    void tablebase_data();
+    void tablebase();
+
+    void mateSolve_data();
+    void mateSolve();
+
+    void search_data();
+    void search();
+
+    void ucci();
+    void ucciClient();
 };
 
 class TestManual : public QObject {
@@ -42,6 +100,9 @@ private slots:
     void toReadWriteFile_data();
     void toReadWriteFile();
 
+    void annotate_data();
+    void annotate();
+
     void toReadWriteDir_data();
     void toReadWriteDir();
 };
@@ -64,6 +125,9 @@ class TestInitEcco : public QObject {
     Q_OBJECT
 private slots:
     void initEcco();
+
+    void setRowcols_data();
+    void setRowcols();
 };
 
 #endif // TEST_H
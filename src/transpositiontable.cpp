@@ -0,0 +1,137 @@
+#include "transpositiontable.h"
+
+#include <new>
+
+#if defined(Q_OS_LINUX)
+#include <sys/mman.h>
+#endif
+#if defined(_MSC_VER)
+#include <xmmintrin.h>
+#endif
+
+// 按2MB对齐分配, 便于系统使用大页
+static const size_t ALLOCALIGNMENT { 2 * 1024 * 1024 };
+static const int HASHFULLSAMPLES { 1000 };
+
+// 数据字: 0~15位着法, 16~31位分值, 32~39位深度, 40~41位界限类型, 42~49位代次
+quint64 TranspositionTable::packData(PackedMove move, int score, int depth, Bound bound, int age)
+{
+    return quint64(move) | (quint64(quint16(qint16(score))) << 16)
+        | (quint64(qBound(0, depth, 0xFF)) << 32) | (quint64(bound) << 40) | (quint64(age) << 42);
+}
+
+TranspositionTable::TranspositionTable(int megabytes)
+{
+    resize(megabytes);
+}
+
+TranspositionTable::~TranspositionTable()
+{
+    qFreeAligned(buckets_);
+}
+
+void TranspositionTable::resize(int megabytes)
+{
+    qFreeAligned(buckets_);
+
+    quint64 count { (quint64(qMax(megabytes, 1)) << 20) / sizeof(Bucket) };
+    bucketCount_ = 1;
+    while (bucketCount_ * 2 <= count)
+        bucketCount_ *= 2;
+
+    size_t size { size_t(bucketCount_ * sizeof(Bucket)) };
+    buckets_ = static_cast<Bucket*>(qMallocAligned(size, ALLOCALIGNMENT));
+    Q_CHECK_PTR(buckets_);
+#if defined(Q_OS_LINUX) && defined(MADV_HUGEPAGE)
+    madvise(buckets_, size, MADV_HUGEPAGE);
+#endif
+    for (quint64 i = 0; i < bucketCount_; ++i)
+        new (buckets_ + i) Bucket;
+
+    clear();
+}
+
+void TranspositionTable::clear()
+{
+    for (quint64 i = 0; i < bucketCount_; ++i)
+        for (auto& entry : buckets_[i].entrys) {
+            entry.key.store(0, std::memory_order_relaxed);
+            entry.data.store(0, std::memory_order_relaxed);
+        }
+
+    age_ = 0;
+}
+
+int TranspositionTable::megabytes() const
+{
+    return int((bucketCount_ * sizeof(Bucket)) >> 20);
+}
+
+bool TranspositionTable::probe(quint64 hash, TableEntry& entry) const
+{
+    for (auto& tableEntry : bucket(hash)->entrys) {
+        quint64 data { tableEntry.data.load(std::memory_order_relaxed) };
+        if ((tableEntry.key.load(std::memory_order_relaxed) ^ data) != hash || data == 0)
+            continue;
+
+        entry.move = PackedMove(data & 0xFFFF);
+        entry.score = qint16(quint16((data >> 16) & 0xFFFF));
+        entry.depth = dataDepth(data);
+        entry.bound = Bound((data >> 40) & 0x3);
+        return true;
+    }
+
+    return false;
+}
+
+void TranspositionTable::store(quint64 hash, PackedMove move, int score, int depth, Bound bound)
+{
+    // 同一局面则覆盖该项; 否则替换深度最浅且代次最旧的项
+    Entry* replace { Q_NULLPTR };
+    int replaceValue { 0 };
+    for (auto& tableEntry : bucket(hash)->entrys) {
+        quint64 data { tableEntry.data.load(std::memory_order_relaxed) };
+        if ((tableEntry.key.load(std::memory_order_relaxed) ^ data) == hash) {
+            // 保留原有着法; 新结果深度较浅且非精确值时不覆盖
+            if (move == 0)
+                move = PackedMove(data & 0xFFFF);
+            if (bound != Bound::EXACT && depth + 2 < dataDepth(data) && dataAge(data) == age_)
+                return;
+
+            replace = &tableEntry;
+            break;
+        }
+
+        int value { dataDepth(data) - 8 * ((age_ - dataAge(data)) & AGEMASK) };
+        if (!replace || value < replaceValue) {
+            replace = &tableEntry;
+            replaceValue = value;
+        }
+    }
+
+    quint64 data { packData(move, score, depth, bound, age_) };
+    replace->key.store(hash ^ data, std::memory_order_relaxed);
+    replace->data.store(data, std::memory_order_relaxed);
+}
+
+void TranspositionTable::prefetch(quint64 hash) const
+{
+#if defined(__GNUC__)
+    __builtin_prefetch(bucket(hash));
+#elif defined(_MSC_VER)
+    _mm_prefetch(reinterpret_cast<const char*>(bucket(hash)), _MM_HINT_T0);
+#endif
+}
+
+int TranspositionTable::hashfull() const
+{
+    int count { 0 }, samples { int(qMin(quint64(HASHFULLSAMPLES), bucketCount_)) };
+    for (int i = 0; i < samples; ++i)
+        for (auto& tableEntry : buckets_[i].entrys) {
+            quint64 data { tableEntry.data.load(std::memory_order_relaxed) };
+            if (data != 0 && dataAge(data) == age_)
+                ++count;
+        }
+
+    return count * 1000 / (samples * BUCKETSIZE);
+}
@@ -0,0 +1,78 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+// 置换表: 以局面Zobrist键索引的定长缓存, 可由多个搜索线程无锁共享
+// 每项存键与数据两个64位字, 键字为"局面键^数据", 读取时异或校验,
+// 并发写入造成的半新半旧项校验不通过, 视为未命中.
+// 每桶4项(64字节, 一个缓存行), 按深度与搜索代次替换.
+
+#include "movelist.h"
+
+#include <atomic>
+
+// 分值界限类型
+enum class Bound {
+    NONE,
+    UPPER,
+    LOWER,
+    EXACT
+};
+
+struct TableEntry {
+    PackedMove move { 0 };
+    int score { 0 };
+    int depth { 0 };
+    Bound bound { Bound::NONE };
+};
+
+class TranspositionTable {
+public:
+    static const int DEFAULTMB { 16 };
+
+    explicit TranspositionTable(int megabytes = DEFAULTMB);
+    ~TranspositionTable();
+
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    // 重新分配(内容清空), 大小按MB取不超过的2的幂个桶
+    void resize(int megabytes);
+    void clear();
+    int megabytes() const;
+
+    // 新一次搜索开始时调用, 旧代次的项优先被替换
+    void newSearch() { age_ = (age_ + 1) & AGEMASK; }
+
+    bool probe(quint64 hash, TableEntry& entry) const;
+    void store(quint64 hash, PackedMove move, int score, int depth, Bound bound);
+
+    // 走子后预取该局面所在的桶
+    void prefetch(quint64 hash) const;
+
+    // 抽样统计当前代次项的占用千分比
+    int hashfull() const;
+
+private:
+    static const int BUCKETSIZE { 4 };
+    static const int AGEMASK { 0xFF };
+
+    struct Entry {
+        std::atomic<quint64> key;
+        std::atomic<quint64> data;
+    };
+
+    struct alignas(64) Bucket {
+        Entry entrys[BUCKETSIZE];
+    };
+
+    Bucket* bucket(quint64 hash) const { return buckets_ + (hash & (bucketCount_ - 1)); }
+
+    static quint64 packData(PackedMove move, int score, int depth, Bound bound, int age);
+    static int dataDepth(quint64 data) { return int((data >> 32) & 0xFF); }
+    static int dataAge(quint64 data) { return int((data >> 42) & AGEMASK); }
+
+    Bucket* buckets_ { Q_NULLPTR };
+    quint64 bucketCount_ { 0 };
+    int age_ { 0 };
+};
+
+#endif // TRANSPOSITIONTABLE_H
@@ -0,0 +1,226 @@
+#include "ucciclient.h"
+#include "board.h"
+#include "piece.h"
+#include "position.h"
+#include "seatbase.h"
+#include "zhnotation.h"
+
+#include <QTimer>
+
+// 退出时等待引擎自行结束的时间(毫秒), 超时则终止进程
+static const int QUITMSECS { 1000 };
+
+QString UcciInfo::toString() const
+{
+    return QString("深度%1 分值%2 结点%3: %4").arg(depth).arg(score).arg(nodes).arg(zhPv.join(' '));
+}
+
+UcciClient::UcciClient(QObject* parent)
+    : QObject(parent)
+    , process_(Q_NULLPTR)
+    , board_(new Board)
+    , pendingColor_(PieceColor::RED)
+{
+}
+
+UcciClient::~UcciClient()
+{
+    quit();
+    delete board_;
+}
+
+void UcciClient::start(const QString& program, const QStringList& arguments)
+{
+    quit();
+    engineName_.clear();
+    process_ = new QProcess(this);
+    connect(process_, &QProcess::readyReadStandardOutput, this, &UcciClient::readOutput);
+    connect(process_, &QProcess::errorOccurred, this, &UcciClient::processError);
+    connect(process_, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+        this, &UcciClient::processFinished);
+
+    state_ = State::STARTING;
+    process_->start(program, arguments);
+    write("ucci");
+}
+
+// 发送quit后不等待: 旧进程与本对象脱离, 结束(或超时被终止)后自行删除
+void UcciClient::quit()
+{
+    pendingFen_.clear();
+    state_ = State::NOTSTARTED;
+    if (!process_)
+        return;
+
+    QProcess* process { process_ };
+    process_ = Q_NULLPTR;
+    process->disconnect(this);
+    process->setParent(Q_NULLPTR);
+    if (process->state() == QProcess::NotRunning) {
+        delete process;
+        return;
+    }
+
+    connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+        process, &QObject::deleteLater);
+    process->write("quit\n");
+    QTimer::singleShot(QUITMSECS, process, &QProcess::kill);
+}
+
+void UcciClient::analyze(const QString& fen, PieceColor sideColor)
+{
+    pendingFen_ = fen;
+    pendingColor_ = sideColor;
+    if (state_ == State::IDLE)
+        startPending();
+    else if (state_ == State::SEARCHING) {
+        write("stop");
+        state_ = State::STOPPING;
+    }
+}
+
+void UcciClient::stopAnalyze()
+{
+    pendingFen_.clear();
+    if (state_ == State::SEARCHING) {
+        write("stop");
+        state_ = State::STOPPING;
+    }
+}
+
+// info depth <深度> score <分值> [nodes <结点数>] [time <毫秒>] pv <着法>...
+UcciInfo UcciClient::parseInfo(const QString& line)
+{
+    UcciInfo info;
+    QStringList fields { line.split(' ', Qt::SkipEmptyParts) };
+    for (int index = 1; index < fields.count() - 1; ++index) {
+        QString name { fields.at(index) };
+        if (name == "pv") {
+            info.pv = fields.mid(index + 1);
+            break;
+        } else if (name == "depth")
+            info.depth = fields.at(++index).toInt();
+        else if (name == "score")
+            info.score = fields.at(++index).toInt();
+        else if (name == "nodes")
+            info.nodes = fields.at(++index).toULongLong();
+    }
+
+    return info;
+}
+
+void UcciClient::readOutput()
+{
+    while (process_ && process_->canReadLine())
+        parseLine(QString::fromLocal8Bit(process_->readLine()).trimmed());
+}
+
+void UcciClient::processError(QProcess::ProcessError error)
+{
+    state_ = State::NOTSTARTED;
+    emit errorOccurred(error == QProcess::FailedToStart
+            ? QString("引擎启动失败: %1").arg(process_->program())
+            : QString("引擎错误: %1").arg(process_->errorString()));
+}
+
+void UcciClient::processFinished()
+{
+    if (state_ == State::NOTSTARTED)
+        return;
+
+    state_ = State::NOTSTARTED;
+    emit errorOccurred("引擎已退出");
+}
+
+void UcciClient::parseLine(const QString& line)
+{
+    QStringList fields { line.split(' ', Qt::SkipEmptyParts) };
+    if (fields.isEmpty())
+        return;
+
+    QString command { fields.first() };
+    if (command == "id") {
+        if (fields.count() > 2 && fields.at(1) == "name")
+            engineName_ = fields.mid(2).join(' ');
+    } else if (command == "ucciok") {
+        if (state_ != State::STARTING)
+            return;
+
+        state_ = State::IDLE;
+        emit ready(engineName_);
+        startPending();
+    } else if (command == "info") {
+        // 中止中的旧局面搜索输出丢弃
+        if (state_ != State::SEARCHING)
+            return;
+
+        UcciInfo info { parseInfo(line) };
+        if (info.pv.isEmpty())
+            return;
+
+        info.zhPv = zhStrings(info.pv);
+        emit infoReceived(info);
+    } else if (command == "bestmove" || command == "nobestmove") {
+        if (state_ == State::SEARCHING) {
+            QString bestMove { command == "bestmove" && fields.count() > 1 ? fields.at(1) : QString() };
+            QStringList zhBestMoves { zhStrings({ bestMove }) };
+            emit bestMoveReceived(bestMove, zhBestMoves.isEmpty() ? QString() : zhBestMoves.first());
+        }
+        if (state_ == State::SEARCHING || state_ == State::STOPPING) {
+            state_ = State::IDLE;
+            startPending();
+        }
+    }
+}
+
+void UcciClient::startPending()
+{
+    if (pendingFen_.isEmpty() || state_ != State::IDLE)
+        return;
+
+    QString fen { pendingFen_ };
+    pendingFen_.clear();
+    if (!board_->setFEN(fen, pendingColor_)) {
+        emit errorOccurred("FEN错误: " + fen);
+        return;
+    }
+
+    // 引擎按红方在下的标准方位解读FEN和坐标着法, 黑方在下的局面先旋转
+    if (board_->position().bottomColor() == PieceColor::BLACK) {
+        board_->changeLayout(ChangeType::ROTATE);
+        fen = board_->getFEN();
+    }
+
+    write(QString("position fen %1 %2 - - 0 1").arg(fen).arg(pendingColor_ == PieceColor::RED ? 'w' : 'b'));
+    write("go infinite");
+    state_ = State::SEARCHING;
+}
+
+void UcciClient::write(const QString& command)
+{
+    if (process_)
+        process_->write((command + '\n').toLocal8Bit());
+}
+
+QStringList UcciClient::zhStrings(const QStringList& iccsMoves) const
+{
+    PackedMove moves[MoveList::MAXCOUNT];
+    int count { 0 };
+    for (auto& iccs : iccsMoves) {
+        QPair<Coord, Coord> coordPair;
+        if (count == MoveList::MAXCOUNT || !SeatBase::iccsCoordPair(iccs, coordPair))
+            break;
+
+        moves[count++] = MoveList::pack(SeatBase::getIndex(coordPair.first), SeatBase::getIndex(coordPair.second));
+    }
+
+    // 在局面副本上逐着走子编码, 棋盘不变
+    Position position { board_->snapshot() };
+    QChar zhChars[MoveList::MAXCOUNT * ZhNotation::ZHLENGTH];
+    count = ZhNotation::encodeMoves(position, moves, count, zhChars);
+    QStringList zhStrs;
+    for (int index = 0; index < count; ++index)
+        zhStrs.append(QString(zhChars + index * ZhNotation::ZHLENGTH, ZhNotation::ZHLENGTH));
+
+    return zhStrs;
+}
@@ -0,0 +1,86 @@
+#ifndef UCCICLIENT_H
+#define UCCICLIENT_H
+// UCCI引擎客户端: 以QProcess运行外部引擎程序, 在事件循环中按行解析输出, 不阻塞界面.
+// 分析时以"go infinite"搜索, 逐条发出info信号(深度、分值、主要变例及其中文着法);
+// 分析中局面改变时先发stop, 待旧搜索的bestmove到达后再开始新局面, 其间收到的旧info丢弃.
+
+#include <QMetaType>
+#include <QObject>
+#include <QProcess>
+#include <QStringList>
+
+class Board;
+enum class PieceColor;
+
+// 引擎输出的一条info: 分值为走棋方视角, 主要变例为坐标着法及其中文着法
+struct UcciInfo {
+    int depth { 0 };
+    int score { 0 };
+    quint64 nodes { 0 };
+    QStringList pv;
+    QStringList zhPv;
+
+    QString toString() const;
+};
+
+Q_DECLARE_METATYPE(UcciInfo)
+
+class UcciClient : public QObject {
+    Q_OBJECT
+
+public:
+    enum class State {
+        NOTSTARTED,
+        STARTING,
+        IDLE,
+        SEARCHING,
+        STOPPING
+    };
+
+    explicit UcciClient(QObject* parent = Q_NULLPTR);
+    ~UcciClient();
+
+    // 启动引擎并发送ucci, 收到ucciok后发出ready信号
+    void start(const QString& program, const QStringList& arguments = {});
+    void quit();
+
+    State state() const { return state_; }
+    const QString& engineName() const { return engineName_; }
+
+    // 分析局面(棋子FEN及走棋方, 黑方在下时按红方在下发给引擎), 正在分析其他局面时先中止
+    void analyze(const QString& fen, PieceColor sideColor);
+    void stopAnalyze();
+
+    // 解析info行的depth、score、nodes、pv字段
+    static UcciInfo parseInfo(const QString& line);
+
+signals:
+    void ready(const QString& engineName);
+    void infoReceived(const UcciInfo& info);
+    void bestMoveReceived(const QString& bestMove, const QString& zhBestMove);
+    void errorOccurred(const QString& message);
+
+private slots:
+    void readOutput();
+    void processError(QProcess::ProcessError error);
+    void processFinished();
+
+private:
+    void parseLine(const QString& line);
+    void startPending();
+    void write(const QString& command);
+
+    // 在当前分析局面上依次转换为中文着法(遇不能转换的着法即止), 局面不变
+    QStringList zhStrings(const QStringList& iccsMoves) const;
+
+    QProcess* process_;
+    Board* board_;
+    State state_ { State::NOTSTARTED };
+    QString engineName_;
+
+    // 待分析的局面: 棋子FEN及走棋方, 为空则无
+    QString pendingFen_;
+    PieceColor pendingColor_;
+};
+
+#endif // UCCICLIENT_H
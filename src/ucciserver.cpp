@@ -0,0 +1,262 @@
+#include "ucciserver.h"
+#include "board.h"
+#include "engine.h"
+#include "perft.h"
+#include "piece.h"
+#include "piecebase.h"
+#include "position.h"
+#include "searchthreads.h"
+#include "seat.h"
+#include "seatbase.h"
+#include "transpositiontable.h"
+
+#include <QThread>
+
+// 时间未指定剩余着数时, 按还需走的着数平均分配
+static const int DEFAULTMOVESTOGO { 30 };
+
+UcciServer::UcciServer(const Output& output)
+    : output_(output)
+    , board_(new Board)
+    , table_(new TranspositionTable)
+    , threadCount_(SearchThreads::idealThreadCount())
+{
+}
+
+UcciServer::~UcciServer()
+{
+    stop();
+    delete table_;
+    delete board_;
+}
+
+bool UcciServer::execute(const QString& line)
+{
+    QStringList fields { line.split(' ', Qt::SkipEmptyParts) };
+    if (fields.isEmpty())
+        return true;
+
+    QString command { fields.first() };
+    if (command == "ucci")
+        ucci();
+    else if (command == "isready")
+        print("readyok");
+    else if (command == "setoption") {
+        stop();
+        setOption(fields);
+    } else if (command == "position") {
+        stop();
+        setPosition(fields);
+    } else if (command == "go") {
+        stop();
+        go(fields);
+    } else if (command == "stop")
+        stop();
+    else if (command == "quit") {
+        stop();
+        print("bye");
+        return false;
+    }
+    // 其他指令(如ponderhit、probe)忽略
+
+    return true;
+}
+
+void UcciServer::wait()
+{
+    if (!searchThread_)
+        return;
+
+    searchThread_->wait();
+    delete searchThread_;
+    delete searchThreads_;
+    searchThread_ = Q_NULLPTR;
+    searchThreads_ = Q_NULLPTR;
+}
+
+quint64 UcciServer::hash() const
+{
+    return board_->hash();
+}
+
+void UcciServer::ucci()
+{
+    print("id name studyChess");
+    print("option usemillisec type check default false");
+    print(QString("option hashsize type spin min 1 max 1024 default %1").arg(TranspositionTable::DEFAULTMB));
+    print(QString("option threads type spin min 1 max 64 default %1").arg(threadCount_));
+    print("ucciok");
+}
+
+void UcciServer::setOption(const QStringList& fields)
+{
+    if (fields.count() < 3)
+        return;
+
+    QString name { fields.at(1) }, value { fields.at(2) };
+    if (name == "hashsize")
+        table_->resize(qBound(1, value.toInt(), 1024));
+    else if (name == "threads")
+        threadCount_ = qBound(1, value.toInt(), 64);
+    else if (name == "usemillisec")
+        millisec_ = (value == "true");
+}
+
+// position {fen <FEN> | startpos} [moves <着法>...]
+// FEN只取棋子与走棋方两段作为局面标识, 回合计数等不影响是否沿用上次的局面
+void UcciServer::setPosition(const QStringList& fields)
+{
+    if (fields.count() < 2)
+        return;
+
+    int movesIndex { fields.indexOf("moves") };
+    QStringList fenFields;
+    if (fields.at(1) == "startpos")
+        fenFields << PieceBase::FENSTR << "w";
+    else if (fields.at(1) == "fen")
+        fenFields = fields.mid(2, movesIndex < 0 ? -1 : movesIndex - 2).mid(0, 2);
+    if (fenFields.isEmpty())
+        return;
+
+    QString fen { fenFields.join(' ') };
+    QStringList moves;
+    if (movesIndex >= 0)
+        moves = fields.mid(movesIndex + 1);
+
+    undoneCount_ = 0;
+    appliedCount_ = 0;
+    if (fen != fen_) {
+        steps_.clear();
+        moves_.clear();
+        history_.clear();
+        PieceColor sideColor { (fenFields.count() > 1 && fenFields.at(1) == "b")
+                ? PieceColor::BLACK
+                : PieceColor::RED };
+        if (!board_->setFEN(fenFields.at(0), sideColor)) {
+            fen_.clear();
+            print("info string FEN错误: " + fen);
+            return;
+        }
+        fen_ = fen;
+    } else {
+        // 同一起始局面: 撤销上次着法列表中与本次不同的后段
+        int sameCount { 0 };
+        while (sameCount < moves_.count() && sameCount < moves.count()
+            && moves_.at(sameCount) == moves.at(sameCount))
+            ++sameCount;
+        while (moves_.count() > sameCount)
+            undoMove();
+    }
+
+    for (int index = moves_.count(); index < moves.count(); ++index)
+        if (!doMove(moves.at(index))) {
+            print("info string 非法着法: " + moves.at(index));
+            break;
+        }
+}
+
+// go [ponder | draw] {depth <深度> | nodes <结点数> | time <剩余时间> [movestogo <着数> | increment <加时>] | infinite}
+void UcciServer::go(const QStringList& fields)
+{
+    if (fen_.isEmpty())
+        return;
+
+    SearchLimits limits;
+    double time { -1 }, increment { 0 };
+    int movesToGo { DEFAULTMOVESTOGO };
+    for (int index = 1; index < fields.count() - 1; ++index) {
+        QString name { fields.at(index) }, value { fields.at(index + 1) };
+        if (name == "depth")
+            limits.depth = value.toInt();
+        else if (name == "nodes")
+            limits.nodes = value.toULongLong();
+        else if (name == "time")
+            time = value.toDouble();
+        else if (name == "movestogo")
+            movesToGo = qMax(value.toInt(), 1);
+        else if (name == "increment")
+            increment = value.toDouble();
+        else
+            continue;
+        ++index;
+    }
+    if (time >= 0) {
+        double unit { millisec_ ? 1.0 : 1000.0 };
+        limits.msecs = qMax(1, int(qMin(time / movesToGo + increment, time / 2) * unit));
+    }
+
+    // 无合法着法时不搜索; 搜索在完成第一次迭代前被中止时, 结果为第一个合法着法
+    MoveList moveList;
+    Position& position { board_->position() };
+    position.generateLegalMoves(position.sideColor(), moveList);
+    if (moveList.isEmpty()) {
+        print("nobestmove");
+        return;
+    }
+
+    searchThreads_ = new SearchThreads(position, table_, threadCount_);
+    searchThreads_->setHistory(history_);
+    searchThreads_->setIterationCallback([this](const SearchResult& result) {
+        QStringList pvStrings;
+        for (PackedMove move : result.pv)
+            pvStrings.append(Perft::moveString(move));
+        print(QString("info depth %1 score %2 nodes %3 time %4 pv %5")
+                  .arg(result.depth)
+                  .arg(result.score)
+                  .arg(result.nodes)
+                  .arg(result.msecs)
+                  .arg(pvStrings.join(' ')));
+    });
+    searchThread_ = QThread::create([this, limits]() {
+        SearchResult result { searchThreads_->search(limits) };
+        QString bestMove { "bestmove " + Perft::moveString(result.bestMove) };
+        if (result.pv.count() > 1)
+            bestMove.append(" ponder " + Perft::moveString(result.pv.at(1)));
+        print(bestMove);
+    });
+    searchThread_->start();
+}
+
+void UcciServer::stop()
+{
+    if (searchThreads_)
+        searchThreads_->stop();
+
+    wait();
+}
+
+bool UcciServer::doMove(const QString& iccs)
+{
+    QPair<Coord, Coord> coordPair;
+    if (!SeatBase::iccsCoordPair(iccs, coordPair))
+        return false;
+
+    SeatPair seatPair { board_->getSeatPair(coordPair) };
+    Seat *fromSeat { seatPair.first }, *toSeat { seatPair.second };
+    Position& position { board_->position() };
+    if (!fromSeat->hasPiece() || fromSeat->piece()->color() != position.sideColor()
+        || !board_->canMove(seatPair))
+        return false;
+
+    history_.push(position.hash(), MoveList::pack(fromSeat->index(), toSeat->index()), toSeat->hasPiece());
+    steps_.append({ fromSeat, toSeat, toSeat->piece() });
+    fromSeat->moveTo(toSeat);
+    moves_.append(iccs);
+    ++appliedCount_;
+    return true;
+}
+
+void UcciServer::undoMove()
+{
+    Step step { steps_.takeLast() };
+    step.toSeat->moveTo(step.fromSeat, step.eatPiece);
+    history_.pop();
+    moves_.removeLast();
+    ++undoneCount_;
+}
+
+void UcciServer::print(const QString& line)
+{
+    QMutexLocker locker(&outputMutex_);
+    output_(line);
+}
@@ -0,0 +1,83 @@
+#ifndef UCCISERVER_H
+#define UCCISERVER_H
+// UCCI引擎协议服务(无界面): 逐行解释界面程序发来的指令, 经回调输出应答.
+// 支持ucci、isready、setoption(hashsize、threads、usemillisec)、position、go、stop、quit.
+// 局面由Board::setFEN设置, 着法经棋盘位置执行, 与Board保持一致; 连续的position指令若FEN相同,
+// 只撤销、执行与上次着法列表不同的部分(对局中通常只多出一两着), 不必每次从头重放全部着法.
+// go指令在工作线程中搜索, 指令线程可随时以stop中止; 每完成一次迭代输出info, 结束时输出bestmove.
+
+#include "repetition.h"
+
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <functional>
+
+class Board;
+class Piece;
+class Seat;
+class SearchThreads;
+class TranspositionTable;
+class QThread;
+
+class UcciServer {
+public:
+    using Output = std::function<void(const QString&)>;
+
+    explicit UcciServer(const Output& output);
+    ~UcciServer();
+
+    UcciServer(const UcciServer&) = delete;
+    UcciServer& operator=(const UcciServer&) = delete;
+
+    // 执行一行指令, 收到quit时返回false
+    bool execute(const QString& line);
+
+    // 等待正在进行的搜索结束
+    void wait();
+
+    // 当前局面的Zobrist键, 及最近一次position指令撤销、执行的着数(测试使用)
+    quint64 hash() const;
+    int undoneCount() const { return undoneCount_; }
+    int appliedCount() const { return appliedCount_; }
+
+private:
+    // 已执行的着法: 起止位置及被吃棋子, 供撤销
+    struct Step {
+        Seat* fromSeat;
+        Seat* toSeat;
+        Piece* eatPiece;
+    };
+
+    void ucci();
+    void setOption(const QStringList& fields);
+    void setPosition(const QStringList& fields);
+    void go(const QStringList& fields);
+    void stop();
+
+    // 执行坐标着法(如"h2e2"), 非法时不执行并返回false
+    bool doMove(const QString& iccs);
+    void undoMove();
+
+    void print(const QString& line);
+
+    Output output_;
+    QMutex outputMutex_;
+
+    Board* board_;
+    QString fen_;
+    QStringList moves_;
+    QList<Step> steps_;
+    RepetitionHistory history_;
+    int undoneCount_ { 0 };
+    int appliedCount_ { 0 };
+
+    TranspositionTable* table_;
+    int threadCount_;
+    bool millisec_ { false };
+    SearchThreads* searchThreads_ { Q_NULLPTR };
+    QThread* searchThread_ { Q_NULLPTR };
+};
+
+#endif // UCCISERVER_H
@@ -0,0 +1,263 @@
+#include "zhnotation.h"
+#include "piece.h"
+#include "position.h"
+#include "seattable.h"
+
+static const int ROWNUM { SeatTable::ROWNUM };
+static const int COLNUM { SeatTable::COLNUM };
+static const int COLORNUM { 2 };
+static const int KINDNUM { 7 };
+static const int MAXSAMEKIND { 5 };
+
+// 与PieceBase中的字符表一致
+static constexpr char16_t NAMECHARS[COLORNUM][KINDNUM + 1] { u"帅仕相马车炮兵", u"将士象马车炮卒" };
+static constexpr char16_t NUMCHARS[COLORNUM][COLNUM + 1] { u"一二三四五六七八九", u"１２３４５６７８９" };
+static constexpr char16_t MOVCHARS[] { u"退平进" };
+// 同列多子的前缀字符: 2子、3子, 及4~5个兵的序号
+static constexpr char16_t PRECHARS[][MAXSAMEKIND + 1] { u"", u"", u"前后", u"前中后", u"一二三四五", u"一二三四五" };
+
+template <int N>
+static int charIndex(const char16_t (&chars)[N], QChar ch)
+{
+    for (int index = 0; index < N - 1; ++index)
+        if (chars[index] == ch.unicode())
+            return index;
+
+    return -1;
+}
+
+static bool isLineKind(PieceKind kind)
+{
+    return kind == PieceKind::KING || kind == PieceKind::ROOK || kind == PieceKind::CANNON
+        || kind == PieceKind::PAWN;
+}
+
+static bool isStrongKind(PieceKind kind)
+{
+    return kind == PieceKind::KNIGHT || kind == PieceKind::ROOK || kind == PieceKind::CANNON
+        || kind == PieceKind::PAWN;
+}
+
+// 列在记谱中的序号(0起): 处于底边的一方从右向左数
+static int colNum(bool isBottom, int col) { return isBottom ? COLNUM - 1 - col : col; }
+
+// 插入排序: 升序或降序
+static void sortSeats(int* seats, int count, bool descending)
+{
+    for (int i = 1; i < count; ++i) {
+        int seat { seats[i] }, j { i };
+        for (; j > 0 && (descending ? seats[j - 1] < seat : seats[j - 1] > seat); --j)
+            seats[j] = seats[j - 1];
+        seats[j] = seat;
+    }
+}
+
+// 某方某种棋子的位置(col < 0 为全部列), 按位置序号(先行后列)升序
+static int kindSeats(const Position& position, PieceColor color, PieceKind kind, int col, int* seats)
+{
+    int count { 0 };
+    for (int pieceIndex = Position::firstPieceIndex(color, kind);
+         pieceIndex < Position::lastPieceIndex(color, kind); ++pieceIndex) {
+        int seat { position.seatIndex(pieceIndex) };
+        if (seat != Position::NOSEAT && (col < 0 || seat % COLNUM == col))
+            seats[count++] = seat;
+    }
+    sortSeats(seats, count, false);
+
+    return count;
+}
+
+// 多兵: 只取有2个及以上兵的列, 先列后行排序, 处于底边的一方从右向左、从上向下
+static int multiPawnSeats(const Position& position, PieceColor color, bool isBottom, int* seats)
+{
+    int pawnSeats[MAXSAMEKIND], colCounts[COLNUM] {};
+    int pawnCount { kindSeats(position, color, PieceKind::PAWN, -1, pawnSeats) };
+    for (int index = 0; index < pawnCount; ++index)
+        ++colCounts[pawnSeats[index] % COLNUM];
+
+    // 排序键: 列*行数+行
+    int count { 0 };
+    for (int index = 0; index < pawnCount; ++index) {
+        int seat { pawnSeats[index] }, col { seat % COLNUM };
+        if (colCounts[col] > 1)
+            seats[count++] = col * ROWNUM + seat / COLNUM;
+    }
+    sortSeats(seats, count, isBottom);
+    for (int index = 0; index < count; ++index)
+        seats[index] = seats[index] % ROWNUM * COLNUM + seats[index] / ROWNUM;
+
+    return count;
+}
+
+static int seatPos(const int* seats, int count, int seat)
+{
+    for (int index = 0; index < count; ++index)
+        if (seats[index] == seat)
+            return index;
+
+    return -1;
+}
+
+bool ZhNotation::encode(const Position& position, int fromIndex, int toIndex, QChar* zhChars)
+{
+    int pieceIndex { position.pieceIndex(fromIndex) };
+    if (pieceIndex == Position::NOPIECE)
+        return false;
+
+    PieceColor color { Position::color(pieceIndex) };
+    PieceKind kind { Position::kind(pieceIndex) };
+    int colorIndex { int(color) };
+    bool isBottom { color == position.bottomColor() };
+    int fromRow { fromIndex / COLNUM }, fromCol { fromIndex % COLNUM },
+        toRow { toIndex / COLNUM }, toCol { toIndex % COLNUM };
+    QChar name { NAMECHARS[colorIndex][int(kind)] };
+
+    int seats[MAXSAMEKIND];
+    int count { isStrongKind(kind) ? kindSeats(position, color, kind, fromCol, seats) : 1 };
+    if (count > 1) {
+        // 兵已按是否底边排序; 其他棋子按行升序, 底边一方行大者为前
+        int preIndex;
+        if (kind == PieceKind::PAWN) {
+            count = multiPawnSeats(position, color, isBottom, seats);
+            preIndex = seatPos(seats, count, fromIndex);
+        } else {
+            int index { seatPos(seats, count, fromIndex) };
+            preIndex = isBottom ? count - 1 - index : index;
+        }
+        zhChars[0] = PRECHARS[count][preIndex];
+        zhChars[1] = name;
+    } else { // 将帅, 仕(士), 相(象): 不用"前"和"后"区别, 因为能退的一定在前, 能进的一定在后
+        zhChars[0] = name;
+        zhChars[1] = NUMCHARS[colorIndex][colNum(isBottom, fromCol)];
+    }
+
+    bool isSameRow { fromRow == toRow };
+    zhChars[2] = MOVCHARS[isSameRow ? 1 : (isBottom == (toRow > fromRow) ? 2 : 0)];
+    zhChars[3] = (isLineKind(kind) && !isSameRow)
+        ? NUMCHARS[colorIndex][qAbs(fromRow - toRow) - 1]
+        : NUMCHARS[colorIndex][colNum(isBottom, toCol)];
+
+    return true;
+}
+
+bool ZhNotation::decode(const Position& position, const QChar* zhChars, int& fromIndex, int& toIndex)
+{
+    // 根据最后一个字符判断该着法属于哪一方
+    PieceColor color { charIndex(NUMCHARS[int(PieceColor::RED)], zhChars[3]) >= 0
+            ? PieceColor::RED
+            : PieceColor::BLACK };
+    int colorIndex { int(color) };
+    bool isBottom { color == position.bottomColor() };
+    int movIndex { charIndex(MOVCHARS, zhChars[2]) }, toNum { charIndex(NUMCHARS[colorIndex], zhChars[3]) };
+    if (movIndex < 0 || toNum < 0)
+        return false;
+
+    int movDir { (movIndex - 1) * (isBottom ? 1 : -1) };
+    int seats[MAXSAMEKIND], count, index;
+    int kindIndex { charIndex(NAMECHARS[colorIndex], zhChars[0]) };
+    PieceKind kind;
+    if (kindIndex >= 0) { // 首字符为棋子名
+        kind = PieceKind(kindIndex);
+        int fromNum { charIndex(NUMCHARS[colorIndex], zhChars[1]) };
+        if (fromNum < 0)
+            return false;
+
+        count = kindSeats(position, color, kind, colNum(isBottom, fromNum), seats);
+        // 仕、象同列时不分前后, 以进、退区分棋子
+        index = (count == 2 && movDir == -1) ? 1 : 0;
+    } else {
+        kindIndex = charIndex(NAMECHARS[colorIndex], zhChars[1]);
+        if (kindIndex < 0)
+            return false;
+
+        kind = PieceKind(kindIndex);
+        bool isMultPawn { kind == PieceKind::PAWN };
+        count = isMultPawn ? multiPawnSeats(position, color, isBottom, seats)
+                           : kindSeats(position, color, kind, -1, seats);
+        if (count < 2)
+            return false;
+
+        index = charIndex(PRECHARS[count], zhChars[0]);
+        if (index >= 0 && !isMultPawn && isBottom)
+            index = count - 1 - index;
+    }
+    if (index < 0 || index >= count)
+        return false;
+
+    fromIndex = seats[index];
+    int fromRow { fromIndex / COLNUM }, fromCol { fromIndex % COLNUM };
+    int toRow { fromRow }, toCol { colNum(isBottom, toNum) };
+    if (isLineKind(kind)) {
+        if (movDir != 0) {
+            toRow += movDir * (toNum + 1);
+            toCol = fromCol;
+        }
+    } else { // 斜线走子: 仕、相、马
+        int colAway { qAbs(toCol - fromCol) }; // 相距1或2列
+        toRow += movDir
+            * ((kind == PieceKind::ADVISOR || kind == PieceKind::BISHOP) ? colAway : (colAway == 1 ? 2 : 1));
+    }
+    if (toRow < 0 || toRow >= ROWNUM)
+        return false;
+
+    toIndex = toRow * COLNUM + toCol;
+    return true;
+}
+
+int ZhNotation::encodeMoves(Position& position, const PackedMove* moves, int count, QChar* zhChars)
+{
+    int eatPieceIndexs[MoveList::MAXCOUNT];
+    int done { 0 };
+    for (; done < count && done < MoveList::MAXCOUNT; ++done) {
+        int fromIndex { MoveList::fromIndex(moves[done]) }, toIndex { MoveList::toIndex(moves[done]) };
+        if (!encode(position, fromIndex, toIndex, zhChars + done * ZHLENGTH))
+            break;
+
+        eatPieceIndexs[done] = position.movePiece(fromIndex, toIndex);
+    }
+
+    for (int index = done - 1; index >= 0; --index)
+        position.undoMovePiece(MoveList::fromIndex(moves[index]), MoveList::toIndex(moves[index]),
+            eatPieceIndexs[index]);
+
+    return done;
+}
+
+int ZhNotation::decodeMoves(Position& position, const QChar* zhChars, int count, PackedMove* moves)
+{
+    int eatPieceIndexs[MoveList::MAXCOUNT];
+    int done { 0 };
+    for (; done < count && done < MoveList::MAXCOUNT; ++done) {
+        int fromIndex, toIndex;
+        if (!decode(position, zhChars + done * ZHLENGTH, fromIndex, toIndex)
+            || Position::color(position.pieceIndex(fromIndex)) != position.sideColor())
+            break;
+
+        moves[done] = MoveList::pack(fromIndex, toIndex);
+        eatPieceIndexs[done] = position.movePiece(fromIndex, toIndex);
+    }
+
+    for (int index = done - 1; index >= 0; --index)
+        position.undoMovePiece(MoveList::fromIndex(moves[index]), MoveList::toIndex(moves[index]),
+            eatPieceIndexs[index]);
+
+    return done;
+}
+
+QString ZhNotation::toZhStr(const Position& position, PackedMove move)
+{
+    QChar zhChars[ZHLENGTH];
+    if (!encode(position, MoveList::fromIndex(move), MoveList::toIndex(move), zhChars))
+        return {};
+
+    return QString(zhChars, ZHLENGTH);
+}
+
+PackedMove ZhNotation::fromZhStr(const Position& position, const QString& zhStr)
+{
+    int fromIndex, toIndex;
+    if (zhStr.size() != ZHLENGTH || !decode(position, zhStr.constData(), fromIndex, toIndex))
+        return 0;
+
+    return MoveList::pack(fromIndex, toIndex);
+}
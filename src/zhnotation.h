@@ -0,0 +1,37 @@
+#ifndef ZHNOTATION_H
+#define ZHNOTATION_H
+// 中文纵线着法编解码: 直接在局面核心的棋子数组上查找同列、同种棋子, 字符均查编译期常量表,
+// 结果写入调用方提供的定长缓冲区, 单个着法的转换不分配堆内存, 也不对棋子列表排序(至多5个, 插入定序).
+// 着法固定为4个字符, 如"炮二平五"、"前车进一"、"一兵平四"; 行列规则与Board::getZhStr相同.
+// 批量接口自当前局面依次转换并试走整个着法序列(至多MoveList::MAXCOUNT着), 完成后撤销, 局面不变.
+
+#include "movelist.h"
+
+#include <QChar>
+#include <QString>
+
+class Position;
+
+namespace ZhNotation {
+
+constexpr int ZHLENGTH { 4 };
+
+// 着法(起止位置序号)编码为中文着法, 起点无子时返回false
+bool encode(const Position& position, int fromIndex, int toIndex, QChar* zhChars);
+
+// 中文着法解码为起止位置序号, 格式不符或无对应棋子时返回false(不检验着法是否合法)
+bool decode(const Position& position, const QChar* zhChars, int& fromIndex, int& toIndex);
+
+// 批量编码: 依次编码并走子, 写入count * ZHLENGTH个字符; 遇不能编码的着法即止, 返回已编码的着数
+int encodeMoves(Position& position, const PackedMove* moves, int count, QChar* zhChars);
+
+// 批量解码: 依次解码并走子(只检验起点为走棋方棋子); 遇不能解码的着法即止, 返回已解码的着数
+int decodeMoves(Position& position, const QChar* zhChars, int count, PackedMove* moves);
+
+// 便利接口, 失败时分别返回空串、0
+QString toZhStr(const Position& position, PackedMove move);
+PackedMove fromZhStr(const Position& position, const QString& zhStr);
+
+};
+
+#endif // ZHNOTATION_H
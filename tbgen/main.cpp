@@ -0,0 +1,65 @@
+#include "tablebase.h"
+#include "tablebasegenerator.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QTextStream>
+#include <QThread>
+
+// 残局库生成工具
+// tbgen [-j 线程数] [-o 目录] [签名...]: 生成签名(如KRvKAA)对应的残局库及其全部子库,
+// 目录中已有的库直接读入; 输出各库局面数、胜负和局面数、最长DTM及耗时
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Tbgen: 残局库逆向生成");
+    parser.addHelpOption();
+    QCommandLineOption threadsOption({ "j", "threads" }, "线程数(默认为处理器核数)", "threads",
+        QString::number(QThread::idealThreadCount()));
+    QCommandLineOption outputOption({ "o", "output" }, "输出目录", "dir", Tablebases::DEFAULTDIR);
+    parser.addOptions({ threadsOption, outputOption });
+    parser.addPositionalArgument("signature", "子力组合签名(默认KRvKAA KNPvKA)");
+    parser.process(app);
+
+    QString dirName { parser.value(outputOption) };
+    if (!QDir().mkpath(dirName)) {
+        out << "无法创建目录: " << dirName << Qt::endl;
+        return 1;
+    }
+
+    QStringList signatures { parser.positionalArguments() };
+    if (signatures.isEmpty())
+        signatures = QStringList { "KRvKAA", "KNPvKA" };
+
+    TablebaseGenerator generator(parser.value(threadsOption).toInt());
+    for (auto& signature : signatures) {
+        if (!generator.generate(signature, dirName)) {
+            out << "生成失败: " << signature << Qt::endl;
+            return 1;
+        }
+    }
+
+    for (auto& signature : generator.signatures()) {
+        TablebaseGenerator::Stats stats { generator.stats(signature) };
+        if (stats.size == 0) {
+            out << QString("%1: 已存在").arg(signature) << Qt::endl;
+            continue;
+        }
+
+        out << QString("%1: %2 局面, 胜%3 负%4 和%5, 最长%6半回合, %7 ms")
+                   .arg(signature)
+                   .arg(stats.size)
+                   .arg(stats.wins)
+                   .arg(stats.losses)
+                   .arg(stats.draws)
+                   .arg(stats.maxDtm)
+                   .arg(stats.msecs)
+            << Qt::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,45 @@
+# 残局库生成工具(无界面): qmake tbgen/tbgen.pro && make
+QT = core
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+TARGET = tbgen
+
+INCLUDEPATH += ../src
+
+# 位棋盘走子后端(qmake "CONFIG+=bitboard"), 见src/bitboard.h
+bitboard: DEFINES += CCHESS_BITBOARD
+
+SOURCES += \
+    main.cpp \
+    ../src/board.cpp \
+    ../src/boardpieces.cpp \
+    ../src/boardseats.cpp \
+    ../src/evaluation.cpp \
+    ../src/fencodec.cpp \
+    ../src/piece.cpp \
+    ../src/piecebase.cpp \
+    ../src/position.cpp \
+    ../src/seat.cpp \
+    ../src/seatbase.cpp \
+    ../src/tablebase.cpp \
+    ../src/tablebasegenerator.cpp \
+    ../src/zhnotation.cpp
+
+HEADERS += \
+    ../src/bitboard.h \
+    ../src/board.h \
+    ../src/boardpieces.h \
+    ../src/boardseats.h \
+    ../src/evaluation.h \
+    ../src/fencodec.h \
+    ../src/movelist.h \
+    ../src/piece.h \
+    ../src/piecebase.h \
+    ../src/position.h \
+    ../src/seat.h \
+    ../src/seatbase.h \
+    ../src/seattable.h \
+    ../src/tablebase.h \
+    ../src/tablebasegenerator.h \
+    ../src/zhnotation.h
@@ -0,0 +1,38 @@
+#include "searchthreads.h"
+#include "transpositiontable.h"
+#include "ucciserver.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTextStream>
+
+// UCCI引擎: 从标准输入逐行读取指令, 应答写至标准输出, 供支持UCCI协议的界面程序加载
+// ucci [-m 置换表MB] [-j 线程数]: 选项与界面发来的setoption hashsize、threads相同
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream in(stdin);
+    QTextStream out(stdout);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("UCCI: 象棋引擎协议服务");
+    parser.addHelpOption();
+    QCommandLineOption hashOption({ "m", "hash" }, "置换表大小(MB, 默认16)", "megabytes",
+        QString::number(TranspositionTable::DEFAULTMB));
+    QCommandLineOption threadsOption({ "j", "threads" }, "搜索线程数(默认为处理器核心数)", "threads",
+        QString::number(SearchThreads::idealThreadCount()));
+    parser.addOptions({ hashOption, threadsOption });
+    parser.process(app);
+
+    // 搜索线程输出bestmove时由服务加锁, 每行立即刷新
+    UcciServer server([&out](const QString& line) { out << line << Qt::endl; });
+    server.execute("setoption hashsize " + parser.value(hashOption));
+    server.execute("setoption threads " + parser.value(threadsOption));
+
+    QString line;
+    while (in.readLineInto(&line))
+        if (!server.execute(line.trimmed()))
+            break;
+
+    return 0;
+}
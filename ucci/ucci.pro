@@ -0,0 +1,55 @@
+# UCCI引擎(无界面): qmake ucci/ucci.pro && make
+QT = core
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+TARGET = ucci
+
+INCLUDEPATH += ../src
+
+# 位棋盘走子后端(qmake "CONFIG+=bitboard"), 见src/bitboard.h
+bitboard: DEFINES += CCHESS_BITBOARD
+
+SOURCES += \
+    main.cpp \
+    ../src/board.cpp \
+    ../src/boardpieces.cpp \
+    ../src/boardseats.cpp \
+    ../src/engine.cpp \
+    ../src/evaluation.cpp \
+    ../src/fencodec.cpp \
+    ../src/moveorder.cpp \
+    ../src/perft.cpp \
+    ../src/piece.cpp \
+    ../src/piecebase.cpp \
+    ../src/position.cpp \
+    ../src/repetition.cpp \
+    ../src/searchthreads.cpp \
+    ../src/seat.cpp \
+    ../src/seatbase.cpp \
+    ../src/transpositiontable.cpp \
+    ../src/ucciserver.cpp \
+    ../src/zhnotation.cpp
+
+HEADERS += \
+    ../src/bitboard.h \
+    ../src/board.h \
+    ../src/boardpieces.h \
+    ../src/boardseats.h \
+    ../src/engine.h \
+    ../src/evaluation.h \
+    ../src/fencodec.h \
+    ../src/movelist.h \
+    ../src/moveorder.h \
+    ../src/perft.h \
+    ../src/piece.h \
+    ../src/piecebase.h \
+    ../src/position.h \
+    ../src/repetition.h \
+    ../src/searchthreads.h \
+    ../src/seat.h \
+    ../src/seatbase.h \
+    ../src/seattable.h \
+    ../src/transpositiontable.h \
+    ../src/ucciserver.h \
+    ../src/zhnotation.h